@@ -81,6 +81,41 @@ void benchmark::PlotlyPrinter::footer()
               << "</script></body></html>";
 }
 
+void benchmark::BreakdownPrinter::header()
+{
+    std::cout << "# Benchmark, median (us/iteration), share" << std::endl;
+}
+
+void benchmark::BreakdownPrinter::result(const State& state)
+{
+    auto results = state.m_elapsed_results;
+    std::sort(results.begin(), results.end());
+
+    double median = 0;
+    if (!results.empty()) {
+        size_t mid = results.size() / 2;
+        median = results[mid];
+        if (0 == results.size() % 2) {
+            median = (results[mid - 1] + results[mid]) / 2;
+        }
+    }
+    m_medians.emplace_back(state.m_name, median);
+}
+
+void benchmark::BreakdownPrinter::footer()
+{
+    double total = 0;
+    for (const auto& m : m_medians) {
+        total += m.second;
+    }
+
+    std::cout << std::fixed;
+    for (const auto& m : m_medians) {
+        std::cout << m.first << ", " << std::setprecision(3) << m.second * 1e6 << ", "
+                  << std::setprecision(1) << (total > 0 ? 100 * m.second / total : 0) << "%" << std::endl;
+    }
+    std::cout << "total, " << std::setprecision(3) << total * 1e6 << ", 100.0%" << std::endl;
+}
 
 benchmark::BenchRunner::BenchmarkMap& benchmark::BenchRunner::benchmarks()
 {
@@ -130,6 +130,19 @@ private:
     int64_t m_width;
     int64_t m_height;
 };
+
+// lists the median time per iteration of every benchmark and its share of
+// the total, e.g. to break a hash chain down into its stages.
+class BreakdownPrinter : public Printer
+{
+public:
+    void header() override;
+    void result(const State& state) override;
+    void footer() override;
+
+private:
+    std::vector<std::pair<std::string, double>> m_medians;
+};
 }
 
 
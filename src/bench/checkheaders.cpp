@@ -0,0 +1,86 @@
+// Copyright (c) 2018-2019 SIN developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+
+#include <arith_uint256.h>
+#include <chainparams.h>
+#include <pow.h>
+#include <primitives/block.h>
+#include <streams.h>
+#include <util.h>
+#include <validation.h>
+#include <version.h>
+
+#include <boost/thread/thread.hpp>
+
+static const int MIN_CORES = 2;
+static const size_t HEADERS_PER_BATCH = 100;
+
+// Build a chain of X25X headers at the minimum mainnet difficulty, serialized
+// so every iteration can deserialize copies without memoized hashes.
+static CDataStream MineHeaders(const Consensus::Params& consensusParams, int nFirstHeight)
+{
+    std::vector<CBlockHeader> headers(HEADERS_PER_BATCH);
+    const uint32_t nBits = UintToArith256(consensusParams.powLimit).GetCompact();
+    for (size_t i = 0; i < headers.size(); ++i) {
+        CBlockHeader& header = headers[i];
+        header.nVersion = 4;
+        header.hashPrevBlock = i ? headers[i - 1].GetHash() : uint256();
+        header.hashMerkleRoot = ArithToUint256(arith_uint256(i + 1));
+        header.nTime = 1540000000 + i * consensusParams.nPowTargetSpacing;
+        header.nBits = nBits;
+        while (!CheckProofOfWork(header.GetPoWHash(nFirstHeight + i), nBits, consensusParams))
+            ++header.nNonce;
+    }
+
+    CDataStream stream(SER_NETWORK, PROTOCOL_VERSION);
+    stream << headers;
+    return stream;
+}
+
+// What AcceptBlockHeader() costs per header when nothing was precomputed
+static void CheckBlockHeadersSerial(benchmark::State& state)
+{
+    SelectParams(CBaseChainParams::MAIN);
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+    const CDataStream stream = MineHeaders(consensusParams, nSinHeightMainnet);
+
+    while (state.KeepRunning()) {
+        CDataStream copy(stream);
+        std::vector<CBlockHeader> headers;
+        copy >> headers;
+        for (size_t i = 0; i < headers.size(); ++i) {
+            headers[i].GetHash();
+            assert(CheckProofOfWork(headers[i].GetPoWHash(nSinHeightMainnet + i), headers[i].nBits, consensusParams));
+        }
+    }
+}
+
+static void CheckBlockHeadersParallel(benchmark::State& state)
+{
+    SelectParams(CBaseChainParams::MAIN);
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+    const CDataStream stream = MineHeaders(consensusParams, nSinHeightMainnet);
+
+    nHeaderCheckThreads = std::max(MIN_CORES, GetNumCores());
+    boost::thread_group tg;
+    for (int i = 0; i < nHeaderCheckThreads - 1; ++i) {
+        tg.create_thread(&ThreadHeaderCheck);
+    }
+
+    while (state.KeepRunning()) {
+        CDataStream copy(stream);
+        std::vector<CBlockHeader> headers;
+        copy >> headers;
+        assert(CheckBlockHeadersPoW(headers, nSinHeightMainnet, consensusParams));
+    }
+
+    tg.interrupt_all();
+    tg.join_all();
+    nHeaderCheckThreads = 0;
+}
+
+BENCHMARK(CheckBlockHeadersSerial, 20);
+BENCHMARK(CheckBlockHeadersParallel, 20);
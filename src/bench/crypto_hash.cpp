@@ -14,6 +14,7 @@
 #include <crypto/sha1.h>
 #include <crypto/sha256.h>
 #include <crypto/sha512.h>
+#include <crypto/x25x.h>
 
 /* Number of bytes to hash per iteration */
 static const uint64_t BUFFER_SIZE = 1000*1000;
@@ -68,6 +69,39 @@ static void SHA512(benchmark::State& state)
         CSHA512().Write(in.data(), in.size()).Finalize(hash);
 }
 
+static void X22I_80b(benchmark::State& state)
+{
+    uint8_t hash[CX22IHasher::OUTPUT_SIZE];
+    std::vector<uint8_t> in(80,0);
+    while (state.KeepRunning()) {
+        CX22IHasher().Write(in.data(), in.size()).Finalize(hash);
+        in[76]++;
+    }
+}
+
+static void X25X_80b(benchmark::State& state)
+{
+    uint8_t hash[CX25XHasher::OUTPUT_SIZE];
+    std::vector<uint8_t> in(80,0);
+    while (state.KeepRunning()) {
+        CX25XHasher().Write(in.data(), in.size()).Finalize(hash);
+        in[76]++;
+    }
+}
+
+static void X25X_80b_8way(benchmark::State& state)
+{
+    uint8_t hash[8][CX25XHasher::OUTPUT_SIZE];
+    std::vector<uint8_t> in(76,0);
+    CX25XHasher hasher;
+    hasher.Write(in.data(), in.size());
+    uint32_t nonce = 0;
+    while (state.KeepRunning()) {
+        hasher.FinalizeNonces(nonce, 8, hash);
+        nonce += 8;
+    }
+}
+
 static void SipHash_32b(benchmark::State& state)
 {
     uint256 x;
@@ -101,6 +135,9 @@ BENCHMARK(SHA256, 340);
 BENCHMARK(SHA512, 330);
 
 BENCHMARK(SHA256_32b, 4700 * 1000);
+BENCHMARK(X22I_80b, 7000);
+BENCHMARK(X25X_80b, 4000);
+BENCHMARK(X25X_80b_8way, 500);
 BENCHMARK(SipHash_32b, 40 * 1000 * 1000);
 BENCHMARK(SHA256D64_1024, 7400);
 BENCHMARK(FastRandom_32bit, 110 * 1000 * 1000);
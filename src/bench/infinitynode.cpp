@@ -0,0 +1,163 @@
+// Copyright (c) 2018-2019 SIN developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+
+#include <arith_uint256.h>
+#include <chain.h>
+#include <chainparams.h>
+#include <crypto/common.h>
+#include <infinitynodeman.h>
+#include <script/standard.h>
+#include <uint256.h>
+
+#include <algorithm>
+
+static const int NODES_PER_SIN_TYPE = 2000;
+static const int STATEMENT_BLOCKS = 12000;
+
+/**
+ * A synthetic chain from nInfinityNodeBeginHeight to STATEMENT_BLOCKS after
+ * the genesis statement, with NODES_PER_SIN_TYPE burn funds of every SIN
+ * type spread over the blocks before the genesis statement (one a block
+ * from nInfinityNodeBeginHeight on when there are fewer, as on regtest), and
+ * coinbases paying one node of every type from there on. The blocks are given to the
+ * manager as scanned from disk, so the benchmarks measure the list and not
+ * block reads.
+ */
+struct CInfinitynodeManBench
+{
+    std::vector<uint256> vHash;
+    std::vector<CBlockIndex> vIndex;
+    std::vector<const CBlockIndex*> vScanIndex;
+    std::vector<CInfinitynodeBlockScan> vScan;
+
+    CInfinitynodeManBench()
+    {
+        const Consensus::Params& consensus = Params().GetConsensus();
+        const int nBeginHeight = consensus.nInfinityNodeBeginHeight;
+        const int nBlocks = consensus.nInfinityNodeGenesisStatement + STATEMENT_BLOCKS - nBeginHeight + 1;
+        const int vSinTypes[] = {10, 5, 1};
+        const int nBurnSpacing = std::max(1, (consensus.nInfinityNodeGenesisStatement - nBeginHeight) / (3 * NODES_PER_SIN_TYPE));
+
+        vHash.resize(nBlocks);
+        vIndex.resize(nBlocks);
+        vScan.resize(nBlocks);
+        for (int i = 0; i < nBlocks; ++i) {
+            vHash[i] = ArithToUint256(arith_uint256(i + 1));
+            vIndex[i].phashBlock = &vHash[i];
+            vIndex[i].nHeight = nBeginHeight + i;
+            vIndex[i].pprev = i ? &vIndex[i - 1] : nullptr;
+            vScanIndex.push_back(&vIndex[i]);
+        }
+
+        for (int n = 0; n < 3 * NODES_PER_SIN_TYPE; ++n) {
+            const int nBlock = n * nBurnSpacing;
+            CInfinitynode inf(PROTOCOL_VERSION, COutPoint(ArithToUint256(arith_uint256(n + 1)), 0));
+            inf.setHeight(vIndex[nBlock].nHeight);
+            inf.setSINType(vSinTypes[n % 3]);
+            inf.setScriptPublicKey(NodeScript(n));
+            vScan[nBlock].vNodes.push_back(inf);
+        }
+        for (int i = consensus.nInfinityNodeGenesisStatement - nBeginHeight; i < nBlocks; ++i) {
+            for (int nType = 0; nType < 3; ++nType) {
+                vScan[i].vPayees.push_back(NodeScript((i % NODES_PER_SIN_TYPE) * 3 + nType));
+            }
+        }
+    }
+
+    static CScript NodeScript(int n)
+    {
+        uint160 id;
+        WriteLE32(id.begin(), n);
+        return GetScriptForDestination(CKeyID(id));
+    }
+
+    const CBlockIndex* Tip() const { return &vIndex.back(); }
+
+    /** What buildInfinitynodeList() does with the blocks once they are read */
+    void BuildList(CInfinitynodeMan& man) const
+    {
+        LOCK(man.cs);
+        man.Clear();
+        man.UpdateChainTip(Tip());
+        man.addScannedBlocks(vScanIndex, 0, vScan, Tip());
+        man.setListTip(Tip());
+        man.publishSnapshot();
+    }
+
+    static void ClearStatements(CInfinitynodeMan& man)
+    {
+        LOCK(man.cs);
+        man.mapStatementBIG.clear();
+        man.mapStatementMID.clear();
+        man.mapStatementLIL.clear();
+    }
+};
+
+static const CInfinitynodeManBench& GetTestChain()
+{
+    SelectParams(CBaseChainParams::REGTEST);
+    static const CInfinitynodeManBench chain;
+    return chain;
+}
+
+static void InfinitynodeBuildList(benchmark::State& state)
+{
+    const CInfinitynodeManBench& chain = GetTestChain();
+    while (state.KeepRunning()) {
+        CInfinitynodeMan man;
+        chain.BuildList(man);
+    }
+}
+
+// All the statements from the genesis statement on, as after a rebuild
+static void InfinitynodeRewardStatement(benchmark::State& state)
+{
+    const CInfinitynodeManBench& chain = GetTestChain();
+    CInfinitynodeMan man;
+    chain.BuildList(man);
+    while (state.KeepRunning()) {
+        CInfinitynodeManBench::ClearStatements(man);
+        assert(man.deterministicRewardStatement(10));
+        assert(man.deterministicRewardStatement(5));
+        assert(man.deterministicRewardStatement(1));
+    }
+}
+
+static void InfinitynodeRank(benchmark::State& state)
+{
+    const CInfinitynodeManBench& chain = GetTestChain();
+    CInfinitynodeMan man;
+    chain.BuildList(man);
+    assert(man.deterministicRewardStatement(10));
+    assert(man.deterministicRewardStatement(5));
+    assert(man.deterministicRewardStatement(1));
+    while (state.KeepRunning()) {
+        man.calculAllInfinityNodesRankAtLastStm();
+    }
+}
+
+// Find the node paid by every block, as block payment checks do
+static void InfinitynodeRewardAtHeight(benchmark::State& state)
+{
+    const CInfinitynodeManBench& chain = GetTestChain();
+    CInfinitynodeMan man;
+    chain.BuildList(man);
+    assert(man.deterministicRewardStatement(10));
+
+    const int nGenesisStatement = Params().GetConsensus().nInfinityNodeGenesisStatement;
+    int nHeight = nGenesisStatement + 1;
+    CInfinitynode inf;
+    while (state.KeepRunning()) {
+        assert(man.deterministicRewardAtHeight(nHeight, 10, inf));
+        if (++nHeight > chain.Tip()->nHeight)
+            nHeight = nGenesisStatement + 1;
+    }
+}
+
+BENCHMARK(InfinitynodeBuildList, 10);
+BENCHMARK(InfinitynodeRewardStatement, 1000);
+BENCHMARK(InfinitynodeRank, 2000);
+BENCHMARK(InfinitynodeRewardAtHeight, 500 * 1000);
@@ -0,0 +1,162 @@
+// Copyright (c) 2018-2019 SIN developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+
+#include <crypto/blake2s.h>
+#include <crypto/gost_streebog.h>
+#include <crypto/lane.h>
+#include <crypto/lyra2.h>
+#include <crypto/sph_blake.h>
+#include <crypto/sph_bmw.h>
+#include <crypto/sph_cubehash.h>
+#include <crypto/sph_echo.h>
+#include <crypto/sph_fugue.h>
+#include <crypto/sph_groestl.h>
+#include <crypto/sph_hamsi.h>
+#include <crypto/sph_haval.h>
+#include <crypto/sph_jh.h>
+#include <crypto/sph_keccak.h>
+#include <crypto/sph_luffa.h>
+#include <crypto/sph_panama.h>
+#include <crypto/sph_sha2.h>
+#include <crypto/sph_shabal.h>
+#include <crypto/sph_shavite.h>
+#include <crypto/sph_simd.h>
+#include <crypto/sph_skein.h>
+#include <crypto/sph_tiger.h>
+#include <crypto/sph_whirlpool.h>
+#include <crypto/x25x.h>
+#include <crypto/SWIFFTX/SWIFFTX.h>
+
+#include <string.h>
+
+// The X25X_StageNN_* benchmarks time every step of the proof of work chain on
+// input of the size it sees there (an 80 byte header for the first stage, the
+// previous 64 byte stage output otherwise), in chain order. Run them with
+// -filter=X25X_Stage.* -printer=breakdown for each stage's share of the chain.
+// The first 22 stages are X22I; the whole chains are benchmarked as
+// X22I_80b and X25X_80b in crypto_hash.cpp.
+
+// Lyra2 parameters as used by the chain
+static const uint64_t LYRA2_TIME_COST = 1;
+static const uint64_t LYRA2_ROWS = 4;
+static const uint64_t LYRA2_COLS = 4;
+
+// One sph stage. Like CX22IHasher/CX25XHasher, start from a copy of an
+// initialized context and feed each output back in as the next input.
+template <typename Context, void (*Init)(void*), void (*Update)(void*, const void*, size_t), void (*Close)(void*, void*)>
+static void SphStage(benchmark::State& state, size_t len)
+{
+    Context initial;
+    Init(&initial);
+    uint64_t buf[10] = {};
+    while (state.KeepRunning()) {
+        Context ctx = initial;
+        Update(&ctx, buf, len);
+        Close(&ctx, buf);
+    }
+}
+
+#define SPH_STAGE(n, ctx, name, len)                            \
+    static void n(benchmark::State& state)                      \
+    {                                                           \
+        SphStage<ctx, name##_init, name, name##_close>(state, len); \
+    }
+
+SPH_STAGE(X25X_Stage01_Blake512, sph_blake512_context, sph_blake512, 80)
+SPH_STAGE(X25X_Stage02_BMW512, sph_bmw512_context, sph_bmw512, 64)
+SPH_STAGE(X25X_Stage03_Groestl512, sph_groestl512_context, sph_groestl512, 64)
+SPH_STAGE(X25X_Stage04_Skein512, sph_skein512_context, sph_skein512, 64)
+SPH_STAGE(X25X_Stage05_JH512, sph_jh512_context, sph_jh512, 64)
+SPH_STAGE(X25X_Stage06_Keccak512, sph_keccak512_context, sph_keccak512, 64)
+SPH_STAGE(X25X_Stage07_Luffa512, sph_luffa512_context, sph_luffa512, 64)
+SPH_STAGE(X25X_Stage08_CubeHash512, sph_cubehash512_context, sph_cubehash512, 64)
+SPH_STAGE(X25X_Stage09_SHAvite512, sph_shavite512_context, sph_shavite512, 64)
+SPH_STAGE(X25X_Stage10_SIMD512, sph_simd512_context, sph_simd512, 64)
+SPH_STAGE(X25X_Stage11_Echo512, sph_echo512_context, sph_echo512, 64)
+SPH_STAGE(X25X_Stage12_Hamsi512, sph_hamsi512_context, sph_hamsi512, 64)
+SPH_STAGE(X25X_Stage13_Fugue512, sph_fugue512_context, sph_fugue512, 64)
+SPH_STAGE(X25X_Stage14_Shabal512, sph_shabal512_context, sph_shabal512, 64)
+SPH_STAGE(X25X_Stage15_Whirlpool, sph_whirlpool_context, sph_whirlpool, 64)
+SPH_STAGE(X25X_Stage16_SHA512, sph_sha512_context, sph_sha512, 64)
+SPH_STAGE(X25X_Stage18_Haval256_5, sph_haval256_5_context, sph_haval256_5, 64)
+SPH_STAGE(X25X_Stage19_Tiger, sph_tiger_context, sph_tiger, 64)
+SPH_STAGE(X25X_Stage21_GOST512, sph_gost512_context, sph_gost512, 64)
+SPH_STAGE(X25X_Stage22_SHA256, sph_sha256_context, sph_sha256, 64)
+SPH_STAGE(X25X_Stage23_Panama, sph_panama_context, sph_panama, 64)
+
+static void X25X_Stage17_SWIFFTX(benchmark::State& state)
+{
+    InitializeSWIFFTX();
+    // compresses four 64 byte stage outputs into one
+    unsigned char in[4 * 64] = {};
+    unsigned char out[SWIFFTX_OUTPUT_BLOCK_SIZE];
+    while (state.KeepRunning()) {
+        ComputeSingleSWIFFTX(in, out, false);
+        memcpy(in, out, 64);
+    }
+}
+
+static void X25X_Stage20_Lyra2(benchmark::State& state)
+{
+    uint64_t matrix[LYRA2_MATRIX_BYTES(LYRA2_ROWS, LYRA2_COLS) / sizeof(uint64_t)];
+    uint64_t in[4] = {};
+    uint64_t out[8];
+    while (state.KeepRunning()) {
+        LYRA2_scratch(out, 32, in, 32, in, 32, LYRA2_TIME_COST, LYRA2_ROWS, LYRA2_COLS, matrix);
+        memcpy(in, out, 32);
+    }
+}
+
+static void X25X_Stage24_Lane512(benchmark::State& state)
+{
+    uint64_t buf[8] = {};
+    while (state.KeepRunning()) {
+        laneHash(512, (const BitSequence*)buf, 512, (BitSequence*)buf);
+    }
+}
+
+static void X25X_Stage25_Shuffle(benchmark::State& state)
+{
+    uint64_t hash[24][8] = {};
+    while (state.KeepRunning()) {
+        X25XShuffle(hash);
+    }
+}
+
+static void X25X_Stage26_Blake2s(benchmark::State& state)
+{
+    uint64_t hash[24][8] = {};
+    while (state.KeepRunning()) {
+        blake2s_simple((uint8_t*)hash[0], hash[0], sizeof(hash));
+    }
+}
+
+BENCHMARK(X25X_Stage01_Blake512, 1200 * 1000);
+BENCHMARK(X25X_Stage02_BMW512, 1200 * 1000);
+BENCHMARK(X25X_Stage03_Groestl512, 150 * 1000);
+BENCHMARK(X25X_Stage04_Skein512, 1200 * 1000);
+BENCHMARK(X25X_Stage05_JH512, 130 * 1000);
+BENCHMARK(X25X_Stage06_Keccak512, 450 * 1000);
+BENCHMARK(X25X_Stage07_Luffa512, 200 * 1000);
+BENCHMARK(X25X_Stage08_CubeHash512, 80 * 1000);
+BENCHMARK(X25X_Stage09_SHAvite512, 300 * 1000);
+BENCHMARK(X25X_Stage10_SIMD512, 120 * 1000);
+BENCHMARK(X25X_Stage11_Echo512, 220 * 1000);
+BENCHMARK(X25X_Stage12_Hamsi512, 100 * 1000);
+BENCHMARK(X25X_Stage13_Fugue512, 100 * 1000);
+BENCHMARK(X25X_Stage14_Shabal512, 450 * 1000);
+BENCHMARK(X25X_Stage15_Whirlpool, 500 * 1000);
+BENCHMARK(X25X_Stage16_SHA512, 1000 * 1000);
+BENCHMARK(X25X_Stage17_SWIFFTX, 35 * 1000);
+BENCHMARK(X25X_Stage18_Haval256_5, 1000 * 1000);
+BENCHMARK(X25X_Stage19_Tiger, 1300 * 1000);
+BENCHMARK(X25X_Stage20_Lyra2, 250 * 1000);
+BENCHMARK(X25X_Stage21_GOST512, 120 * 1000);
+BENCHMARK(X25X_Stage22_SHA256, 600 * 1000);
+BENCHMARK(X25X_Stage23_Panama, 400 * 1000);
+BENCHMARK(X25X_Stage24_Lane512, 100 * 1000);
+BENCHMARK(X25X_Stage25_Shuffle, 22 * 1000);
+BENCHMARK(X25X_Stage26_Blake2s, 100 * 1000);
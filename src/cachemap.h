@@ -143,6 +143,18 @@ public:
         return true;
     }
 
+    /// Same as Get but also makes the item the most recently used one, so it is pruned last
+    bool GetAndTouch(const K& key, V& value)
+    {
+        map_it it = mapIndex.find(key);
+        if(it == mapIndex.end()) {
+            return false;
+        }
+        listItems.splice(listItems.begin(), listItems, it->second);
+        value = it->second->value;
+        return true;
+    }
+
     void Erase(const K& key)
     {
         map_it it = mapIndex.find(key);
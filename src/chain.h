@@ -213,6 +213,9 @@ public:
     uint32_t nBits;
     uint32_t nNonce;
 
+    //! proof of work hash of the header, null if it was never computed
+    uint256 hashPoW;
+
     //! (memory only) Sequential id assigned to distinguish order in which blocks are received.
     int32_t nSequenceId;
 
@@ -240,6 +243,7 @@ public:
         nTime          = 0;
         nBits          = 0;
         nNonce         = 0;
+        hashPoW        = uint256();
     }
 
     CBlockIndex()
@@ -296,6 +300,8 @@ public:
 
     uint256 GetBlockPoWHash() const
     {
+        if (!hashPoW.IsNull())
+            return hashPoW;
         return GetBlockHeader().GetPoWHash(nHeight);
     }
 
@@ -451,6 +451,14 @@ public:
     CRegTestParams() {
         strNetworkID = "regtest";
         consensus.nSubsidyHalvingInterval = 150;
+        consensus.nMasternodeMinimumConfirmations = 1;
+        consensus.nMasternodeCollateralMinimum = 10;
+        consensus.nMasternodeBurnSINNODE_1 = 100000;
+        consensus.nMasternodeBurnSINNODE_5 = 500000;
+        consensus.nMasternodeBurnSINNODE_10 = 1000000;
+        consensus.nLimitSINNODE_1=6;
+        consensus.nLimitSINNODE_5=6;
+        consensus.nLimitSINNODE_10=6;
         consensus.nInfinityNodeBeginHeight=100;
         consensus.nInfinityNodeGenesisStatement=110;
 
@@ -719,14 +719,19 @@ echo_small_compress(sph_echo_small_context *sc)
 	COMPRESS_SMALL(sc);
 }
 
-static void
-echo_big_compress(sph_echo_big_context *sc)
+/* see sph_echo.h */
+void
+sph_echo_big_compress_ref(sph_echo_big_context *sc)
 {
 	DECL_STATE_BIG
 
 	COMPRESS_BIG(sc);
 }
 
+/* see sph_echo.h */
+void (*sph_echo_big_compress)(sph_echo_big_context *sc) =
+	sph_echo_big_compress_ref;
+
 static void
 echo_small_core(sph_echo_small_context *sc,
 	const unsigned char *data, size_t len)
@@ -790,7 +795,7 @@ echo_big_core(sph_echo_big_context *sc,
 		len -= clen;
 		if (ptr == sizeof sc->buf) {
 			INCR_COUNTER(sc, 1024);
-			echo_big_compress(sc);
+			sph_echo_big_compress(sc);
 			ptr = 0;
 		}
 	}
@@ -897,13 +902,13 @@ echo_big_close(sph_echo_big_context *sc, unsigned ub, unsigned n,
 	buf[ptr ++] = ((ub & -z) | z) & 0xFF;
 	memset(buf + ptr, 0, (sizeof sc->buf) - ptr);
 	if (ptr > ((sizeof sc->buf) - 18)) {
-		echo_big_compress(sc);
+		sph_echo_big_compress(sc);
 		sc->C0 = sc->C1 = sc->C2 = sc->C3 = 0;
 		memset(buf, 0, sizeof sc->buf);
 	}
 	sph_enc16le(buf + (sizeof sc->buf) - 18, out_size_w32 << 5);
 	memcpy(buf + (sizeof sc->buf) - 16, u.tmp, 16);
-	echo_big_compress(sc);
+	sph_echo_big_compress(sc);
 #if SPH_ECHO_64
 	for (VV = &sc->u.Vb[0][0], k = 0; k < ((out_size_w32 + 1) >> 1); k ++)
 		sph_enc64le_aligned(u.tmp + (k << 3), VV[k]);
@@ -860,12 +860,32 @@ fugue3_core(sph_fugue_context *sc, const void *data, size_t len)
 	WRITE_STATE_BIG(sc);
 }
 
-static void
-fugue4_core(sph_fugue_context *sc, const void *data, size_t len)
+/*
+ * Like NEXT(), for a count of whole words.
+ */
+#define NEXT_WORD(rc) \
+	if (n == 0) { \
+		rshift = (rc); \
+		break; \
+	} \
+	p = sph_dec32be(data); \
+	data = (const unsigned char *)data + 4; \
+	n --
+
+/* see sph_fugue.h */
+void
+sph_fugue512_words_ref(sph_fugue_context *sc, const void *data, size_t n)
 {
 	DECL_STATE_BIG
-	CORE_ENTRY
+	sph_u32 p;
+	unsigned rshift;
+
+	if (n == 0)
+		return;
 	READ_STATE_BIG(sc);
+	p = sph_dec32be(data);
+	data = (const unsigned char *)data + 4;
+	n --;
 	rshift = sc->round_shift;
 	switch (rshift) {
 		for (;;) {
@@ -882,7 +902,7 @@ fugue4_core(sph_fugue_context *sc, const void *data, size_t len)
 			SMIX(S27, S28, S29, S30);
 			CMIX36(S24, S25, S26, S28, S29, S30, S06, S07, S08);
 			SMIX(S24, S25, S26, S27);
-			NEXT(1);
+			NEXT_WORD(1);
 			/* fall through */
 		case 1:
 			q = p;
@@ -895,7 +915,7 @@ fugue4_core(sph_fugue_context *sc, const void *data, size_t len)
 			SMIX(S15, S16, S17, S18);
 			CMIX36(S12, S13, S14, S16, S17, S18, S30, S31, S32);
 			SMIX(S12, S13, S14, S15);
-			NEXT(2);
+			NEXT_WORD(2);
 			/* fall through */
 		case 2:
 			q = p;
@@ -908,11 +928,32 @@ fugue4_core(sph_fugue_context *sc, const void *data, size_t len)
 			SMIX(S03, S04, S05, S06);
 			CMIX36(S00, S01, S02, S04, S05, S06, S18, S19, S20);
 			SMIX(S00, S01, S02, S03);
-			NEXT(0);
+			NEXT_WORD(0);
 		}
 	}
-	CORE_EXIT
 	WRITE_STATE_BIG(sc);
+	sc->round_shift = rshift;
+}
+
+/* see sph_fugue.h */
+void (*sph_fugue512_words)(sph_fugue_context *sc, const void *data,
+	size_t n) = sph_fugue512_words_ref;
+
+static void
+fugue4_core(sph_fugue_context *sc, const void *data, size_t len)
+{
+	unsigned char buf[4];
+	size_t n;
+	CORE_ENTRY
+	sph_enc32be(buf, p);
+	sph_fugue512_words(sc, buf, 1);
+	/* as with NEXT(), the last word is kept in sc->partial */
+	n = len > 4 ? (len - 1) >> 2 : 0;
+	sph_fugue512_words(sc, data, n);
+	data = (const unsigned char *)data + (n << 2);
+	len -= n << 2;
+	rshift = sc->round_shift;
+	CORE_EXIT
 }
 
 #if SPH_64
@@ -1047,12 +1088,12 @@ fugue3_close(sph_fugue_context *sc, unsigned ub, unsigned n, void *dst)
 	sph_fugue384_init(sc);
 }
 
-static void
-fugue4_close(sph_fugue_context *sc, unsigned ub, unsigned n, void *dst)
+/* see sph_fugue.h */
+void
+sph_fugue512_final_ref(sph_u32 *S)
 {
 	int i;
 
-	CLOSE_ENTRY(36, 12, fugue4_core)
 	for (i = 0; i < 32; i ++) {
 		ROR(3, 36);
 		CMIX36(S[0], S[1], S[2], S[4], S[5], S[6], S[18], S[19], S[20]);
@@ -1088,6 +1129,16 @@ fugue4_close(sph_fugue_context *sc, unsigned ub, unsigned n, void *dst)
 	S[9] ^= S[0];
 	S[18] ^= S[0];
 	S[27] ^= S[0];
+}
+
+/* see sph_fugue.h */
+void (*sph_fugue512_final)(sph_u32 *S) = sph_fugue512_final_ref;
+
+static void
+fugue4_close(sph_fugue_context *sc, unsigned ub, unsigned n, void *dst)
+{
+	CLOSE_ENTRY(36, 12, fugue4_core)
+	sph_fugue512_final(S);
 	out = dst;
 	sph_enc32be(out +  0, S[ 1]);
 	sph_enc32be(out +  4, S[ 2]);
@@ -2734,6 +2734,38 @@ static const sph_u32 T3dn[] = {
 
 #endif
 
+/* see sph_groestl.h */
+void
+sph_groestl_big_compress_ref(sph_groestl_big_context *sc)
+{
+	unsigned char *buf;
+	DECL_STATE_BIG
+
+	buf = sc->buf;
+	READ_STATE_BIG(sc);
+	COMPRESS_BIG;
+	WRITE_STATE_BIG(sc);
+}
+
+/* see sph_groestl.h */
+void
+sph_groestl_big_final_ref(sph_groestl_big_context *sc)
+{
+	DECL_STATE_BIG
+
+	READ_STATE_BIG(sc);
+	FINAL_BIG;
+	WRITE_STATE_BIG(sc);
+}
+
+/* see sph_groestl.h */
+void (*sph_groestl_big_compress)(sph_groestl_big_context *sc) =
+	sph_groestl_big_compress_ref;
+
+/* see sph_groestl.h */
+void (*sph_groestl_big_final)(sph_groestl_big_context *sc) =
+	sph_groestl_big_final_ref;
+
 static void
 groestl_small_init(sph_groestl_small_context *sc, unsigned out_size)
 {
@@ -2906,7 +2938,6 @@ groestl_big_core(sph_groestl_big_context *sc, const void *data, size_t len)
 {
 	unsigned char *buf;
 	size_t ptr;
-	DECL_STATE_BIG
 
 	buf = sc->buf;
 	ptr = sc->ptr;
@@ -2917,7 +2948,6 @@ groestl_big_core(sph_groestl_big_context *sc, const void *data, size_t len)
 		return;
 	}
 
-	READ_STATE_BIG(sc);
 	while (len > 0) {
 		size_t clen;
 
@@ -2929,7 +2959,7 @@ groestl_big_core(sph_groestl_big_context *sc, const void *data, size_t len)
 		data = (const unsigned char *)data + clen;
 		len -= clen;
 		if (ptr == sizeof sc->buf) {
-			COMPRESS_BIG;
+			sph_groestl_big_compress(sc);
 #if SPH_64
 			sc->count ++;
 #else
@@ -2939,7 +2969,6 @@ groestl_big_core(sph_groestl_big_context *sc, const void *data, size_t len)
 			ptr = 0;
 		}
 	}
-	WRITE_STATE_BIG(sc);
 	sc->ptr = ptr;
 }
 
@@ -2989,8 +3018,8 @@ groestl_big_close(sph_groestl_big_context *sc,
 	sph_enc64be(pad + pad_len - 4, count_low);
 #endif
 	groestl_big_core(sc, pad, pad_len);
+	sph_groestl_big_final(sc);
 	READ_STATE_BIG(sc);
-	FINAL_BIG;
 #if SPH_GROESTL_64
 	for (u = 0; u < 8; u ++)
 		enc64e(pad + (u << 3), H[u + 8]);
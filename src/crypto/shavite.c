@@ -725,8 +725,8 @@ c256(sph_shavite_small_context *sc, const void *msg)
 /*
  * This function assumes that "msg" is aligned for 32-bit access.
  */
-static void
-c512(sph_shavite_big_context *sc, const void *msg)
+void
+sph_shavite_big_compress_ref(sph_shavite_big_context *sc, const void *msg)
 {
 	sph_u32 p0, p1, p2, p3, p4, p5, p6, p7;
 	sph_u32 p8, p9, pA, pB, pC, pD, pE, pF;
@@ -896,8 +896,8 @@ c512(sph_shavite_big_context *sc, const void *msg)
 /*
  * This function assumes that "msg" is aligned for 32-bit access.
  */
-static void
-c512(sph_shavite_big_context *sc, const void *msg)
+void
+sph_shavite_big_compress_ref(sph_shavite_big_context *sc, const void *msg)
 {
 	sph_u32 p0, p1, p2, p3, p4, p5, p6, p7;
 	sph_u32 p8, p9, pA, pB, pC, pD, pE, pF;
@@ -1550,6 +1550,10 @@ shavite_small_close(sph_shavite_small_context *sc,
 		sph_enc32le((unsigned char *)dst + (u << 2), sc->h[u]);
 }
 
+/* see sph_shavite.h */
+void (*sph_shavite_big_compress)(sph_shavite_big_context *sc,
+	const void *msg) = sph_shavite_big_compress_ref;
+
 static void
 shavite_big_init(sph_shavite_big_context *sc, const sph_u32 *iv)
 {
@@ -1590,7 +1594,7 @@ shavite_big_core(sph_shavite_big_context *sc, const void *data, size_t len)
 					}
 				}
 			}
-			c512(sc, buf);
+			sph_shavite_big_compress(sc, buf);
 			ptr = 0;
 		}
 	}
@@ -1624,7 +1628,7 @@ shavite_big_close(sph_shavite_big_context *sc,
 	} else {
 		buf[ptr ++] = z;
 		memset(buf + ptr, 0, 128 - ptr);
-		c512(sc, buf);
+		sph_shavite_big_compress(sc, buf);
 		memset(buf, 0, 110);
 		sc->count0 = sc->count1 = sc->count2 = sc->count3 = 0;
 	}
@@ -1634,7 +1638,7 @@ shavite_big_close(sph_shavite_big_context *sc,
 	sph_enc32le(buf + 122, count3);
 	buf[126] = out_size_w32 << 5;
 	buf[127] = out_size_w32 >> 3;
-	c512(sc, buf);
+	sph_shavite_big_compress(sc, buf);
 	for (u = 0; u < out_size_w32; u ++)
 		sph_enc32le((unsigned char *)dst + (u << 2), sc->h[u]);
 }
@@ -312,6 +312,23 @@ void sph_echo512_close(void *cc, void *dst);
  */
 void sph_echo512_addbits_and_close(
 	void *cc, unsigned ub, unsigned n, void *dst);
+
+/**
+ * Process the 128-byte block buffered in an ECHO-384/ECHO-512 context
+ * (the block counter must already include it). This is the portable
+ * implementation.
+ *
+ * @param sc   the context
+ */
+void sph_echo_big_compress_ref(sph_echo_big_context *sc);
+
+/**
+ * The block processing function used by the ECHO-384/ECHO-512 functions.
+ * It is <code>sph_echo_big_compress_ref()</code> unless a hardware
+ * accelerated implementation was selected at startup (see
+ * <code>X25XAutoDetect()</code>); all implementations give the same output.
+ */
+extern void (*sph_echo_big_compress)(sph_echo_big_context *sc);
 	
 #ifdef __cplusplus
 }
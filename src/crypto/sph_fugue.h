@@ -74,6 +74,36 @@ void sph_fugue512_close(void *cc, void *dst);
 void sph_fugue512_addbits_and_close(
 	void *cc, unsigned ub, unsigned n, void *dst);
 
+/**
+ * Run the Fugue-512 rounds for <code>n</code> 32-bit big-endian input
+ * words on the state of a context (the bit count and partial word are
+ * not updated). This is the portable implementation.
+ *
+ * @param sc     the context
+ * @param data   the input words
+ * @param n      the number of words
+ */
+void sph_fugue512_words_ref(sph_fugue_context *sc, const void *data, size_t n);
+
+/**
+ * Run the Fugue-512 final rounds on the 36 word state, rotated so that
+ * the first word is the one the rounds start from. This is the portable
+ * implementation.
+ *
+ * @param S   the state
+ */
+void sph_fugue512_final_ref(sph_u32 *S);
+
+/**
+ * The round functions used by the Fugue-512 functions. They are the
+ * <code>*_ref()</code> ones unless a hardware accelerated implementation
+ * was selected at startup (see <code>X25XAutoDetect()</code>); all
+ * implementations give the same output.
+ */
+extern void (*sph_fugue512_words)(sph_fugue_context *sc, const void *data,
+	size_t n);
+extern void (*sph_fugue512_final)(sph_u32 *S);
+
 #ifdef __cplusplus
 }
 #endif	
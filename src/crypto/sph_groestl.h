@@ -322,6 +322,34 @@ void sph_groestl512_close(void *cc, void *dst);
 void sph_groestl512_addbits_and_close(
 	void *cc, unsigned ub, unsigned n, void *dst);
 
+/**
+ * Process the 128-byte block buffered in a Groestl-384/Groestl-512
+ * context (the block counter is not updated). This is the portable
+ * implementation.
+ *
+ * @param sc   the context
+ */
+void sph_groestl_big_compress_ref(sph_groestl_big_context *sc);
+
+/**
+ * Apply the output transformation to the chaining value of a
+ * Groestl-384/Groestl-512 context, once the last block has been
+ * processed. This is the portable implementation.
+ *
+ * @param sc   the context
+ */
+void sph_groestl_big_final_ref(sph_groestl_big_context *sc);
+
+/**
+ * The block processing and output transformation functions used by the
+ * Groestl-384/Groestl-512 functions. They are the <code>*_ref()</code>
+ * ones unless a hardware accelerated implementation was selected at
+ * startup (see <code>X25XAutoDetect()</code>); all implementations give
+ * the same output.
+ */
+extern void (*sph_groestl_big_compress)(sph_groestl_big_context *sc);
+extern void (*sph_groestl_big_final)(sph_groestl_big_context *sc);
+
 #ifdef __cplusplus
 }
 #endif
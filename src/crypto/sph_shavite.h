@@ -306,6 +306,26 @@ void sph_shavite512_close(void *cc, void *dst);
  */
 void sph_shavite512_addbits_and_close(
 	void *cc, unsigned ub, unsigned n, void *dst);
+
+/**
+ * Process one 128-byte message block with the SHAvite-384/SHAvite-512
+ * compression function, using the bit counter of the context. This is the
+ * portable implementation.
+ *
+ * @param sc    the context
+ * @param msg   the message block (aligned for 32-bit access)
+ */
+void sph_shavite_big_compress_ref(sph_shavite_big_context *sc,
+	const void *msg);
+
+/**
+ * The compression function used by the SHAvite-384/SHAvite-512 functions.
+ * It is <code>sph_shavite_big_compress_ref()</code> unless a hardware
+ * accelerated implementation was selected at startup (see
+ * <code>X25XAutoDetect()</code>); all implementations give the same output.
+ */
+extern void (*sph_shavite_big_compress)(sph_shavite_big_context *sc,
+	const void *msg);
 	
 #ifdef __cplusplus
 }
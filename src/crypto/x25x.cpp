@@ -0,0 +1,487 @@
+// Copyright (c) 2018-2019 SIN developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <crypto/x25x.h>
+
+#include <crypto/blake2s.h>
+#include <crypto/common.h>
+#include <crypto/gost_streebog.h>
+#include <crypto/lane.h>
+#include <crypto/lyra2.h>
+#include <crypto/sph_bmw.h>
+#include <crypto/sph_cubehash.h>
+#include <crypto/sph_echo.h>
+#include <crypto/sph_fugue.h>
+#include <crypto/sph_groestl.h>
+#include <crypto/sph_hamsi.h>
+#include <crypto/sph_haval.h>
+#include <crypto/sph_jh.h>
+#include <crypto/sph_keccak.h>
+#include <crypto/sph_luffa.h>
+#include <crypto/sph_panama.h>
+#include <crypto/sph_sha2.h>
+#include <crypto/sph_shabal.h>
+#include <crypto/sph_shavite.h>
+#include <crypto/sph_simd.h>
+#include <crypto/sph_skein.h>
+#include <crypto/sph_tiger.h>
+#include <crypto/sph_whirlpool.h>
+#include <crypto/SWIFFTX/SWIFFTX.h>
+
+#include <assert.h>
+#include <string.h>
+
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__amd64__) || defined(__i386__)
+#if defined(USE_ASM)
+#include <cpuid.h>
+#endif
+#endif
+
+namespace echo_aesni
+{
+void Compress(sph_echo_big_context* sc);
+}
+
+namespace fugue_aesni
+{
+void Words(sph_fugue_context* sc, const void* data, size_t n);
+void Final(sph_u32* S);
+}
+
+namespace groestl_aesni
+{
+void Compress(sph_groestl_big_context* sc);
+void Final(sph_groestl_big_context* sc);
+}
+
+namespace shavite_aesni
+{
+void Compress(sph_shavite_big_context* sc, const void* msg);
+}
+
+namespace
+{
+/** Lyra2 parameters used by both chains */
+static const uint64_t LYRA2_TIME_COST = 1;
+static const uint64_t LYRA2_ROWS = 4;
+static const uint64_t LYRA2_COLS = 4;
+
+/** Number of hashes that go through the chain together in the batch functions */
+static const size_t MAX_BATCH_LANES = 8;
+
+/** One context per stage after the first */
+struct ChainContexts
+{
+    sph_blake512_context blake;
+    sph_bmw512_context bmw;
+    sph_groestl512_context groestl;
+    sph_skein512_context skein;
+    sph_jh512_context jh;
+    sph_keccak512_context keccak;
+    sph_luffa512_context luffa;
+    sph_cubehash512_context cubehash;
+    sph_shavite512_context shavite;
+    sph_simd512_context simd;
+    sph_echo512_context echo;
+    sph_hamsi512_context hamsi;
+    sph_fugue512_context fugue;
+    sph_shabal512_context shabal;
+    sph_whirlpool_context whirlpool;
+    sph_sha512_context sha512;
+    sph_haval256_5_context haval;
+    sph_tiger_context tiger;
+    sph_gost512_context gost;
+    sph_sha256_context sha256;
+    sph_panama_context panama;
+};
+
+/** Every stage's 64 byte output slot for one hash. Zeroed before use, so
+ *  shorter digests leave the tail zero. */
+typedef uint64_t ChainHashes[25][8];
+
+/** Contexts as left by their *_init() functions. Built once (together with
+ *  the SWIFFTX tables) and copied from for every hash. */
+const ChainContexts& InitialContexts()
+{
+    static const ChainContexts initial = [] {
+        ChainContexts c;
+        sph_blake512_init(&c.blake);
+        sph_bmw512_init(&c.bmw);
+        sph_groestl512_init(&c.groestl);
+        sph_skein512_init(&c.skein);
+        sph_jh512_init(&c.jh);
+        sph_keccak512_init(&c.keccak);
+        sph_luffa512_init(&c.luffa);
+        sph_cubehash512_init(&c.cubehash);
+        sph_shavite512_init(&c.shavite);
+        sph_simd512_init(&c.simd);
+        sph_echo512_init(&c.echo);
+        sph_hamsi512_init(&c.hamsi);
+        sph_fugue512_init(&c.fugue);
+        sph_shabal512_init(&c.shabal);
+        sph_whirlpool_init(&c.whirlpool);
+        sph_sha512_init(&c.sha512);
+        sph_haval256_5_init(&c.haval);
+        sph_tiger_init(&c.tiger);
+        sph_gost512_init(&c.gost);
+        sph_sha256_init(&c.sha256);
+        sph_panama_init(&c.panama);
+        InitializeSWIFFTX();
+        return c;
+    }();
+    return initial;
+}
+
+/** Run one sph stage for all lanes: hash slot stage - 1 into slot stage,
+ *  starting from a copy of an initialized context each time. */
+template <void (*Update)(void*, const void*, size_t), void (*Close)(void*, void*), typename Context>
+void inline RunStage(const Context& initial, ChainHashes* lanes, size_t count, int stage)
+{
+    for (size_t i = 0; i < count; ++i) {
+        Context ctx = initial;
+        Update(&ctx, lanes[i][stage - 1], 64);
+        Close(&ctx, lanes[i][stage]);
+    }
+}
+
+/** Run the X22I stages following blake512, whose output is in slot 0 of
+ *  every lane. The X22I digests end up in slot 21.
+ *
+ *  Lanes go through the chain together, one stage at a time, so the code
+ *  and tables of a stage are only brought into cache once per batch rather
+ *  than once per hash. */
+void RunX22IStages(ChainHashes* lanes, size_t count)
+{
+    const ChainContexts& ctx = InitialContexts();
+
+    RunStage<sph_bmw512, sph_bmw512_close>(ctx.bmw, lanes, count, 1);
+    RunStage<sph_groestl512, sph_groestl512_close>(ctx.groestl, lanes, count, 2);
+    RunStage<sph_skein512, sph_skein512_close>(ctx.skein, lanes, count, 3);
+    RunStage<sph_jh512, sph_jh512_close>(ctx.jh, lanes, count, 4);
+    RunStage<sph_keccak512, sph_keccak512_close>(ctx.keccak, lanes, count, 5);
+    RunStage<sph_luffa512, sph_luffa512_close>(ctx.luffa, lanes, count, 6);
+    RunStage<sph_cubehash512, sph_cubehash512_close>(ctx.cubehash, lanes, count, 7);
+    RunStage<sph_shavite512, sph_shavite512_close>(ctx.shavite, lanes, count, 8);
+    RunStage<sph_simd512, sph_simd512_close>(ctx.simd, lanes, count, 9);
+    RunStage<sph_echo512, sph_echo512_close>(ctx.echo, lanes, count, 10);
+    RunStage<sph_hamsi512, sph_hamsi512_close>(ctx.hamsi, lanes, count, 11);
+    RunStage<sph_fugue512, sph_fugue512_close>(ctx.fugue, lanes, count, 12);
+    RunStage<sph_shabal512, sph_shabal512_close>(ctx.shabal, lanes, count, 13);
+    RunStage<sph_whirlpool, sph_whirlpool_close>(ctx.whirlpool, lanes, count, 14);
+    RunStage<sph_sha512, sph_sha512_close>(ctx.sha512, lanes, count, 15);
+
+    // SWIFFTX compresses slots 12..15 and produces 65 bytes, of which 64 are kept
+    for (size_t i = 0; i < count; ++i) {
+        unsigned char temp[SWIFFTX_OUTPUT_BLOCK_SIZE] = {0};
+        ComputeSingleSWIFFTX((unsigned char*)lanes[i][12], temp, false);
+        memcpy(lanes[i][16], temp, 64);
+    }
+
+    RunStage<sph_haval256_5, sph_haval256_5_close>(ctx.haval, lanes, count, 17);
+    RunStage<sph_tiger, sph_tiger_close>(ctx.tiger, lanes, count, 18);
+
+    uint64_t lyra2Matrix[LYRA2_MATRIX_BYTES(LYRA2_ROWS, LYRA2_COLS) / sizeof(uint64_t)];
+    for (size_t i = 0; i < count; ++i) {
+        LYRA2_scratch(lanes[i][19], 32, lanes[i][18], 32, lanes[i][18], 32, LYRA2_TIME_COST, LYRA2_ROWS, LYRA2_COLS, lyra2Matrix);
+    }
+
+    RunStage<sph_gost512, sph_gost512_close>(ctx.gost, lanes, count, 20);
+    RunStage<sph_sha256, sph_sha256_close>(ctx.sha256, lanes, count, 21);
+}
+
+/** The X25X shuffle, in place over the first 24 slots of each lane. Each
+ *  lane is one long chain of dependent loads and stores, so the lanes are
+ *  stepped together to let their memory accesses overlap. */
+void ShuffleLanes(uint16_t* const* lanes, size_t count)
+{
+    // simple shuffle algorithm
+    static const int X25X_SHUFFLE_BLOCKS = 24 /* number of algos so far */ * 64 /* output bytes per algo */ / 2 /* block size */;
+    static const int X25X_SHUFFLE_ROUNDS = 12;
+    static const uint16_t x25x_round_const[X25X_SHUFFLE_ROUNDS] = {
+        0x142c, 0x5830, 0x678c, 0xe08c,
+        0x3c67, 0xd50d, 0xb1d8, 0xecb2,
+        0xd7ee, 0x6783, 0xfa6c, 0x4b9c
+    };
+
+    for (int r = 0; r < X25X_SHUFFLE_ROUNDS; r++) {
+        for (int i = 0; i < X25X_SHUFFLE_BLOCKS; i++) {
+            const uint16_t round_value = x25x_round_const[r] << (i % 16);
+            for (size_t l = 0; l < count; l++) {
+                uint16_t* block_pointer = lanes[l];
+                uint16_t block_value = block_pointer[X25X_SHUFFLE_BLOCKS - i - 1];
+                block_pointer[i] ^= block_pointer[block_value % X25X_SHUFFLE_BLOCKS] + round_value;
+            }
+        }
+    }
+}
+
+/** Run the whole X25X chain after blake512. The digests end up in slot 24. */
+void RunX25XStages(ChainHashes* lanes, size_t count)
+{
+    RunX22IStages(lanes, count);
+
+    RunStage<sph_panama, sph_panama_close>(InitialContexts().panama, lanes, count, 22);
+
+    for (size_t i = 0; i < count; ++i) {
+        laneHash(512, (const BitSequence*)lanes[i][22], 512, (BitSequence*)lanes[i][23]);
+    }
+
+    uint16_t* blocks[MAX_BATCH_LANES];
+    for (size_t i = 0; i < count; ++i) {
+        blocks[i] = (uint16_t*)lanes[i];
+    }
+    ShuffleLanes(blocks, count);
+
+    for (size_t i = 0; i < count; ++i) {
+        blake2s_simple((uint8_t*)lanes[i][24], lanes[i][0], 64 * 24);
+    }
+}
+
+/** Finish a single hash: the blake512 context holds the input. Uses one
+ *  lane of scratch rather than the batch path's MAX_BATCH_LANES. */
+template <void (*Run)(ChainHashes*, size_t), int digestSlot>
+void FinalizeOne(sph_blake512_context& blake, unsigned char hash[32])
+{
+    ChainHashes lane;
+    memset(lane, 0, sizeof(lane));
+    sph_blake512_close(&blake, lane[0]);
+    Run(&lane, 1);
+    memcpy(hash, lane[digestSlot], 32);
+}
+
+/** Finish up to MAX_BATCH_LANES hashes: the blake512 contexts hold the
+ *  input of each lane, the digests are taken from slot digestSlot. */
+template <void (*Run)(ChainHashes*, size_t), int digestSlot>
+void FinalizeLanes(sph_blake512_context* blake, size_t count, unsigned char (*hashes)[32])
+{
+    ChainHashes lanes[MAX_BATCH_LANES];
+    memset(lanes, 0, count * sizeof(ChainHashes));
+    for (size_t i = 0; i < count; ++i) {
+        sph_blake512_close(&blake[i], lanes[i][0]);
+    }
+    Run(lanes, count);
+    for (size_t i = 0; i < count; ++i) {
+        memcpy(hashes[i], lanes[i][digestSlot], 32);
+    }
+}
+
+/** Hash the data in prefix followed by each of count consecutive nonces */
+template <void (*Run)(ChainHashes*, size_t), int digestSlot>
+void FinalizeNonces(const sph_blake512_context& prefix, uint32_t nNonce, size_t count, unsigned char (*hashes)[32])
+{
+    sph_blake512_context blake[MAX_BATCH_LANES];
+    while (count > 0) {
+        size_t n = std::min(count, MAX_BATCH_LANES);
+        for (size_t i = 0; i < n; ++i) {
+            unsigned char nonce[4];
+            WriteLE32(nonce, nNonce++);
+            blake[i] = prefix;
+            sph_blake512(&blake[i], nonce, sizeof(nonce));
+        }
+        if (n == 1) {
+            FinalizeOne<Run, digestSlot>(blake[0], hashes[0]);
+        } else {
+            FinalizeLanes<Run, digestSlot>(blake, n, hashes);
+        }
+        hashes += n;
+        count -= n;
+    }
+}
+
+/** Hash count inputs of len bytes each, stored back to back */
+template <void (*Run)(ChainHashes*, size_t), int digestSlot>
+void HashBatch(const unsigned char* data, size_t len, size_t count, unsigned char (*hashes)[32])
+{
+    sph_blake512_context blake[MAX_BATCH_LANES];
+    while (count > 0) {
+        size_t n = std::min(count, MAX_BATCH_LANES);
+        for (size_t i = 0; i < n; ++i) {
+            blake[i] = InitialContexts().blake;
+            sph_blake512(&blake[i], data, len);
+            data += len;
+        }
+        if (n == 1) {
+            FinalizeOne<Run, digestSlot>(blake[0], hashes[0]);
+        } else {
+            FinalizeLanes<Run, digestSlot>(blake, n, hashes);
+        }
+        hashes += n;
+        count -= n;
+    }
+}
+
+#if defined(USE_ASM) && (defined(__x86_64__) || defined(__amd64__) || defined(__i386__))
+// We can't use cpuid.h's __get_cpuid as it does not support subleafs.
+void inline cpuid(uint32_t leaf, uint32_t subleaf, uint32_t& a, uint32_t& b, uint32_t& c, uint32_t& d)
+{
+#ifdef __GNUC__
+    __cpuid_count(leaf, subleaf, a, b, c, d);
+#else
+  __asm__ ("cpuid" : "=a"(a), "=b"(b), "=c"(c), "=d"(d) : "0"(leaf), "2"(subleaf));
+#endif
+}
+#endif
+
+/** Check that the selected compression functions agree with the portable ones. */
+bool SelfTest()
+{
+    unsigned char in[300];
+    for (size_t i = 0; i < sizeof(in); ++i) {
+        in[i] = i * 7 + 1;
+    }
+    unsigned char out[2][64];
+
+    void (*echo)(sph_echo_big_context*) = sph_echo_big_compress;
+    for (int i = 0; i < 2; ++i) {
+        sph_echo512_context ctx;
+        sph_echo_big_compress = i ? echo : sph_echo_big_compress_ref;
+        sph_echo512_init(&ctx);
+        sph_echo512(&ctx, in, sizeof(in));
+        sph_echo512_close(&ctx, out[i]);
+    }
+    sph_echo_big_compress = echo;
+    if (memcmp(out[0], out[1], 64)) return false;
+
+    void (*fugue)(sph_fugue_context*, const void*, size_t) = sph_fugue512_words;
+    void (*fugue_final)(sph_u32*) = sph_fugue512_final;
+    for (int i = 0; i < 2; ++i) {
+        sph_fugue512_context ctx;
+        sph_fugue512_words = i ? fugue : sph_fugue512_words_ref;
+        sph_fugue512_final = i ? fugue_final : sph_fugue512_final_ref;
+        sph_fugue512_init(&ctx);
+        sph_fugue512(&ctx, in, sizeof(in));
+        sph_fugue512_close(&ctx, out[i]);
+    }
+    sph_fugue512_words = fugue;
+    sph_fugue512_final = fugue_final;
+    if (memcmp(out[0], out[1], 64)) return false;
+
+    void (*groestl)(sph_groestl_big_context*) = sph_groestl_big_compress;
+    void (*groestl_final)(sph_groestl_big_context*) = sph_groestl_big_final;
+    for (int i = 0; i < 2; ++i) {
+        sph_groestl512_context ctx;
+        sph_groestl_big_compress = i ? groestl : sph_groestl_big_compress_ref;
+        sph_groestl_big_final = i ? groestl_final : sph_groestl_big_final_ref;
+        sph_groestl512_init(&ctx);
+        sph_groestl512(&ctx, in, sizeof(in));
+        sph_groestl512_close(&ctx, out[i]);
+    }
+    sph_groestl_big_compress = groestl;
+    sph_groestl_big_final = groestl_final;
+    if (memcmp(out[0], out[1], 64)) return false;
+
+    void (*shavite)(sph_shavite_big_context*, const void*) = sph_shavite_big_compress;
+    for (int i = 0; i < 2; ++i) {
+        sph_shavite512_context ctx;
+        sph_shavite_big_compress = i ? shavite : sph_shavite_big_compress_ref;
+        sph_shavite512_init(&ctx);
+        sph_shavite512(&ctx, in, sizeof(in));
+        sph_shavite512_close(&ctx, out[i]);
+    }
+    sph_shavite_big_compress = shavite;
+    if (memcmp(out[0], out[1], 64)) return false;
+
+    return true;
+}
+} // namespace
+
+std::string X25XAutoDetect()
+{
+    std::string ret = "standard";
+#if defined(USE_ASM) && (defined(__x86_64__) || defined(__amd64__) || defined(__i386__))
+    uint32_t eax, ebx, ecx, edx;
+    cpuid(1, 0, eax, ebx, ecx, edx);
+    bool have_ssse3 = (ecx >> 9) & 1;
+    bool have_aesni = (ecx >> 25) & 1;
+    (void)have_ssse3;
+    (void)have_aesni;
+
+#if defined(ENABLE_AESNI) && !defined(BUILD_BITCOIN_INTERNAL)
+    if (have_ssse3 && have_aesni) {
+        sph_echo_big_compress = echo_aesni::Compress;
+        sph_fugue512_words = fugue_aesni::Words;
+        sph_fugue512_final = fugue_aesni::Final;
+        sph_groestl_big_compress = groestl_aesni::Compress;
+        sph_groestl_big_final = groestl_aesni::Final;
+        sph_shavite_big_compress = shavite_aesni::Compress;
+        ret = "aesni(echo,fugue,groestl,shavite)";
+    }
+#endif
+#endif
+
+    assert(SelfTest());
+    return ret;
+}
+
+void X25XShuffle(uint64_t hash[24][8])
+{
+    uint16_t* blocks = (uint16_t*)hash;
+    ShuffleLanes(&blocks, 1);
+}
+
+CX22IHasher::CX22IHasher()
+{
+    Reset();
+}
+
+CX22IHasher& CX22IHasher::Write(const unsigned char* data, size_t len)
+{
+    sph_blake512(&ctx_blake, data, len);
+    return *this;
+}
+
+void CX22IHasher::Finalize(unsigned char hash[OUTPUT_SIZE])
+{
+    FinalizeOne<RunX22IStages, 21>(ctx_blake, hash);
+}
+
+void CX22IHasher::FinalizeNonces(uint32_t nNonce, size_t count, unsigned char (*hashes)[OUTPUT_SIZE]) const
+{
+    ::FinalizeNonces<RunX22IStages, 21>(ctx_blake, nNonce, count, hashes);
+}
+
+void CX22IHasher::HashBatch(const unsigned char* data, size_t len, size_t count, unsigned char (*hashes)[OUTPUT_SIZE])
+{
+    ::HashBatch<RunX22IStages, 21>(data, len, count, hashes);
+}
+
+CX22IHasher& CX22IHasher::Reset()
+{
+    ctx_blake = InitialContexts().blake;
+    return *this;
+}
+
+CX25XHasher::CX25XHasher()
+{
+    Reset();
+}
+
+CX25XHasher& CX25XHasher::Write(const unsigned char* data, size_t len)
+{
+    sph_blake512(&ctx_blake, data, len);
+    return *this;
+}
+
+void CX25XHasher::Finalize(unsigned char hash[OUTPUT_SIZE])
+{
+    FinalizeOne<RunX25XStages, 24>(ctx_blake, hash);
+}
+
+void CX25XHasher::FinalizeNonces(uint32_t nNonce, size_t count, unsigned char (*hashes)[OUTPUT_SIZE]) const
+{
+    ::FinalizeNonces<RunX25XStages, 24>(ctx_blake, nNonce, count, hashes);
+}
+
+void CX25XHasher::HashBatch(const unsigned char* data, size_t len, size_t count, unsigned char (*hashes)[OUTPUT_SIZE])
+{
+    ::HashBatch<RunX25XStages, 24>(data, len, count, hashes);
+}
+
+CX25XHasher& CX25XHasher::Reset()
+{
+    ctx_blake = InitialContexts().blake;
+    return *this;
+}
@@ -0,0 +1,78 @@
+// Copyright (c) 2018-2019 SIN developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_CRYPTO_X25X_H
+#define BITCOIN_CRYPTO_X25X_H
+
+#include <crypto/sph_blake.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string>
+
+/** A hasher class for X22I, the block hash (and proof of work hash before X25X).
+ *
+ *  Input is streamed into the first stage (blake512); Finalize() runs the
+ *  remaining stages from precomputed contexts in stack scratch memory, so no
+ *  context setup or heap allocation happens per hash.
+ *
+ *  The batch functions push up to 8 hashes through the chain one stage at a
+ *  time, which keeps each stage's code and tables in cache. The stages still
+ *  hash each lane on its own (only the X25X shuffle steps the lanes together),
+ *  and a batch needs about 13KB of stack. Finalize() does not go through
+ *  them. Their results are the same as hashing the inputs one by one.
+ */
+class CX22IHasher
+{
+private:
+    sph_blake512_context ctx_blake;
+
+public:
+    static const size_t OUTPUT_SIZE = 32;
+
+    CX22IHasher();
+    CX22IHasher& Write(const unsigned char* data, size_t len);
+    void Finalize(unsigned char hash[OUTPUT_SIZE]);
+    CX22IHasher& Reset();
+
+    /** Hash the data written so far followed by each of count consecutive
+     *  little-endian 32 bit nonces, starting at nNonce. Leaves the hasher
+     *  unchanged, so it serves as a midstate for the common prefix. */
+    void FinalizeNonces(uint32_t nNonce, size_t count, unsigned char (*hashes)[OUTPUT_SIZE]) const;
+
+    /** Hash count inputs of len bytes each, stored back to back in data. */
+    static void HashBatch(const unsigned char* data, size_t len, size_t count, unsigned char (*hashes)[OUTPUT_SIZE]);
+};
+
+/** A hasher class for X25X, the proof of work hash. */
+class CX25XHasher
+{
+private:
+    sph_blake512_context ctx_blake;
+
+public:
+    static const size_t OUTPUT_SIZE = 32;
+
+    CX25XHasher();
+    CX25XHasher& Write(const unsigned char* data, size_t len);
+    void Finalize(unsigned char hash[OUTPUT_SIZE]);
+    CX25XHasher& Reset();
+
+    /** See CX22IHasher::FinalizeNonces() */
+    void FinalizeNonces(uint32_t nNonce, size_t count, unsigned char (*hashes)[OUTPUT_SIZE]) const;
+
+    /** See CX22IHasher::HashBatch() */
+    static void HashBatch(const unsigned char* data, size_t len, size_t count, unsigned char (*hashes)[OUTPUT_SIZE]);
+};
+
+/** Autodetect the best available implementations of the stages that have
+ *  hardware accelerated versions, and return a description of them. Must be
+ *  called before any hashing threads are started. */
+std::string X25XAutoDetect();
+
+/** The X25X shuffle step, applied in place to the first 24 stage outputs.
+ *  Part of CX25XHasher::Finalize(); exposed for benchmarking. */
+void X25XShuffle(uint64_t hash[24][8]);
+
+#endif // BITCOIN_CRYPTO_X25X_H
@@ -0,0 +1,558 @@
+// Copyright (c) 2018-2019 SIN developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+//
+// AES-NI implementations of the AES round based X25X compression functions.
+// They are drop-in replacements for the portable ones in echo.c, fugue.c,
+// groestl.c and shavite.c, selected by X25XAutoDetect().
+
+#ifdef ENABLE_AESNI
+
+#include <stdint.h>
+#include <string.h>
+#include <immintrin.h>
+#include <utility>
+
+#include <crypto/common.h>
+#include <crypto/sph_echo.h>
+#include <crypto/sph_fugue.h>
+#include <crypto/sph_groestl.h>
+#include <crypto/sph_shavite.h>
+
+namespace {
+
+__m128i inline Xor(__m128i x, __m128i y) { return _mm_xor_si128(x, y); }
+
+/** Multiply every byte by 2 in GF(2^8) with the AES polynomial. */
+__m128i inline __attribute__((always_inline)) Mul2(__m128i x)
+{
+    const __m128i carry = _mm_cmpgt_epi8(_mm_setzero_si128(), x);
+    return Xor(_mm_add_epi8(x, x), _mm_and_si128(carry, _mm_set1_epi8(0x1b)));
+}
+
+} // namespace
+
+namespace echo_aesni {
+namespace {
+
+void inline ShiftRow1(__m128i* W, int a, int b, int c, int d)
+{
+    __m128i t = W[a];
+    W[a] = W[b];
+    W[b] = W[c];
+    W[c] = W[d];
+    W[d] = t;
+}
+
+void inline MixColumn(__m128i* W, int ia, int ib, int ic, int id)
+{
+    __m128i a = W[ia], b = W[ib], c = W[ic], d = W[id];
+    __m128i ab = Xor(a, b), bc = Xor(b, c), cd = Xor(c, d);
+    __m128i abx = Mul2(ab), bcx = Mul2(bc), cdx = Mul2(cd);
+    W[ia] = Xor(Xor(abx, bc), d);
+    W[ib] = Xor(Xor(bcx, a), cd);
+    W[ic] = Xor(Xor(cdx, ab), d);
+    W[id] = Xor(Xor(abx, bcx), Xor(Xor(cdx, ab), c));
+}
+
+} // namespace
+
+void Compress(sph_echo_big_context* sc)
+{
+    __m128i W[16];
+    for (int i = 0; i < 8; ++i) {
+        W[i] = _mm_loadu_si128((const __m128i*)sc->u.Vs[i]);
+        W[i + 8] = _mm_loadu_si128((const __m128i*)(sc->buf + 16 * i));
+    }
+
+    // The 128 bit salt (block counter), incremented for every word
+    uint64_t k0 = sc->C0 | ((uint64_t)sc->C1 << 32);
+    uint64_t k1 = sc->C2 | ((uint64_t)sc->C3 << 32);
+    const __m128i zero = _mm_setzero_si128();
+
+    for (int r = 0; r < 10; ++r) {
+        // BIG.SubWords
+        for (int i = 0; i < 16; ++i) {
+            W[i] = _mm_aesenc_si128(W[i], _mm_set_epi64x(k1, k0));
+            W[i] = _mm_aesenc_si128(W[i], zero);
+            if (++k0 == 0) ++k1;
+        }
+
+        // BIG.ShiftRows
+        ShiftRow1(W, 1, 5, 9, 13);
+        std::swap(W[2], W[10]);
+        std::swap(W[6], W[14]);
+        ShiftRow1(W, 15, 11, 7, 3);
+
+        // BIG.MixColumns
+        MixColumn(W, 0, 1, 2, 3);
+        MixColumn(W, 4, 5, 6, 7);
+        MixColumn(W, 8, 9, 10, 11);
+        MixColumn(W, 12, 13, 14, 15);
+    }
+
+    // BIG.Final
+    for (int i = 0; i < 8; ++i) {
+        __m128i v = _mm_loadu_si128((const __m128i*)sc->u.Vs[i]);
+        __m128i m = _mm_loadu_si128((const __m128i*)(sc->buf + 16 * i));
+        _mm_storeu_si128((__m128i*)sc->u.Vs[i], Xor(Xor(v, m), Xor(W[i], W[i + 8])));
+    }
+}
+
+} // namespace echo_aesni
+
+namespace fugue_aesni {
+namespace {
+
+/** Shuffles for SMIX, see SMix() */
+alignas(16) const int8_t SMIX_GATHER[15][16] = {
+    {0, 13, 10, 0, 13, 13, 10, 4, 0, 10, 10, 11, 8, 1, 0, 12},
+    {4, 1, 4, 13, 10, 1, 8, 1, 1, 7, 2, 8, 5, 14, 10, 9},
+    {8, 5, 14, 7, 4, 6, 15, 15, 14, 1, 12, 5, 2, 11, 7, 3},
+    {12, 2, 11, 11, 8, 3, 6, 3, 8, 9, 3, 3, -1, -1, -1, -1},
+    {9, 15, 2, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {6, 9, 6, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {6, 15, 4, 13, 10, 3, 8, 1, 0, 13, 10, 11, 2, 11, 0, 9},
+    {-1, -1, -1, -1, -1, -1, -1, -1, 4, 7, 2, 5, -1, -1, -1, -1},
+    {-1, -1, -1, -1, -1, -1, -1, -1, 14, 1, 12, 15, -1, -1, -1, -1},
+    {-1, -1, -1, -1, -1, -1, -1, -1, 8, 9, 6, 3, -1, -1, -1, -1},
+    {6, 8, 4, 13, 10, 12, 8, 1, 0, 0, 10, 11, 0, 13, 0, 11},
+    {3, 15, 1, 10, 7, 3, 5, 14, 4, 13, 2, 5, 4, 4, 13, 15},
+    {-1, -1, -1, -1, -1, -1, -1, -1, 14, 7, 12, 2, 8, 1, 10, 9},
+    {-1, -1, -1, -1, -1, -1, -1, -1, 11, 1, 9, 15, 2, 11, 2, 6},
+    {-1, -1, -1, -1, -1, -1, -1, -1, 8, 9, 6, 3, 15, 9, 6, 3},
+};
+
+/** Where word i of the 36 word state is, for a state starting at word b */
+constexpr int At(int b, int i) { return (b + i) % 36; }
+
+/** SMIX on four state words.
+ *
+ *  After the S-box, SMIX is linear over GF(2^8): every output byte is a sum
+ *  of input bytes times 1, 4, 5, 6 or 7. The shuffles gather the input bytes
+ *  each bit of those factors applies to (the first six for bit 0, the next
+ *  four for bit 1, the last five for bit 2). They index the aesenclast
+ *  output, which is in AES ShiftRows order. */
+__m128i inline __attribute__((always_inline)) SMix(__m128i x)
+{
+    const __m128i* gather = (const __m128i*)SMIX_GATHER;
+    x = _mm_aesenclast_si128(x, _mm_setzero_si128());
+
+    __m128i x1 = Xor(Xor(_mm_shuffle_epi8(x, gather[0]), _mm_shuffle_epi8(x, gather[1])),
+                     Xor(_mm_shuffle_epi8(x, gather[2]), _mm_shuffle_epi8(x, gather[3])));
+    x1 = Xor(x1, Xor(_mm_shuffle_epi8(x, gather[4]), _mm_shuffle_epi8(x, gather[5])));
+    __m128i x2 = Xor(Xor(_mm_shuffle_epi8(x, gather[6]), _mm_shuffle_epi8(x, gather[7])),
+                     Xor(_mm_shuffle_epi8(x, gather[8]), _mm_shuffle_epi8(x, gather[9])));
+    __m128i x4 = Xor(Xor(_mm_shuffle_epi8(x, gather[10]), _mm_shuffle_epi8(x, gather[11])),
+                     Xor(_mm_shuffle_epi8(x, gather[12]), _mm_shuffle_epi8(x, gather[13])));
+    x4 = Xor(x4, _mm_shuffle_epi8(x, gather[14]));
+    return Xor(x1, Mul2(Xor(x2, Mul2(x4))));
+}
+
+/** Store x to words 0..3 of the state starting at word B */
+template <int B>
+void inline __attribute__((always_inline)) Store(uint32_t* S, __m128i x)
+{
+    S[At(B, 0)] = _mm_cvtsi128_si32(x);
+    S[At(B, 1)] = _mm_cvtsi128_si32(_mm_shuffle_epi32(x, _MM_SHUFFLE(1, 1, 1, 1)));
+    S[At(B, 2)] = _mm_cvtsi128_si32(_mm_shuffle_epi32(x, _MM_SHUFFLE(2, 2, 2, 2)));
+    S[At(B, 3)] = _mm_cvtsi128_si32(_mm_shuffle_epi32(x, _MM_SHUFFLE(3, 3, 3, 3)));
+}
+
+/** SMIX on words 0..3 of the state starting at word B */
+template <int B>
+__m128i inline __attribute__((always_inline)) SMix(uint32_t* S)
+{
+    __m128i x = SMix(_mm_setr_epi32(S[At(B, 0)], S[At(B, 1)], S[At(B, 2)], S[At(B, 3)]));
+    Store<B>(S, x);
+    return x;
+}
+
+/** CMIX36 and SMIX on the state starting at word B */
+template <int B>
+__m128i inline __attribute__((always_inline)) CMixSMix(uint32_t* S)
+{
+    S[At(B, 0)] ^= S[At(B, 4)];
+    S[At(B, 1)] ^= S[At(B, 5)];
+    S[At(B, 2)] ^= S[At(B, 6)];
+    S[At(B, 18)] ^= S[At(B, 4)];
+    S[At(B, 19)] ^= S[At(B, 5)];
+    S[At(B, 20)] ^= S[At(B, 6)];
+    return SMix<B>(S);
+}
+
+/** CMixSMix() following a ROR3 of the state the previous SMIX output x was
+ *  stored to. That output is words 3..6, so the SMIX input comes from
+ *  registers rather than from the words just stored. */
+template <int B>
+__m128i inline __attribute__((always_inline)) CMixSMix(uint32_t* S, __m128i x)
+{
+    S[At(B, 18)] ^= S[At(B, 4)];
+    S[At(B, 19)] ^= S[At(B, 5)];
+    S[At(B, 20)] ^= S[At(B, 6)];
+    x = _mm_shuffle_epi32(x, _MM_SHUFFLE(0, 3, 2, 1));
+    x = SMix(Xor(x, _mm_setr_epi32(S[At(B, 0)], S[At(B, 1)], S[At(B, 2)], 0)));
+    Store<B>(S, x);
+    return x;
+}
+
+/** Four times ROR3, CMIX36 and SMIX, for the state starting at word B and
+ *  the last SMIX output x. The state then starts at At(B, 24). */
+template <int B>
+__m128i inline __attribute__((always_inline)) SubRounds(uint32_t* S, __m128i x)
+{
+    x = CMixSMix<At(B, 33)>(S, x);
+    x = CMixSMix<At(B, 30)>(S, x);
+    x = CMixSMix<At(B, 27)>(S, x);
+    return CMixSMix<At(B, 24)>(S, x);
+}
+
+/** The round for input word p, TIX4 followed by the sub-rounds */
+template <int B>
+void inline __attribute__((always_inline)) Round(uint32_t* S, uint32_t p)
+{
+    S[At(B, 22)] ^= S[At(B, 0)];
+    S[At(B, 0)] = p;
+    S[At(B, 8)] ^= p;
+    S[At(B, 1)] ^= S[At(B, 24)];
+    S[At(B, 4)] ^= S[At(B, 27)];
+    S[At(B, 7)] ^= S[At(B, 30)];
+    __m128i x = CMixSMix<At(B, 33)>(S);
+    x = CMixSMix<At(B, 30)>(S, x);
+    x = CMixSMix<At(B, 27)>(S, x);
+    CMixSMix<At(B, 24)>(S, x);
+}
+
+/** One of the 13 iterations of the second part of the final rounds. The
+ *  state then starts at At(B, 1). */
+template <int B>
+void inline __attribute__((always_inline)) FinalRound(uint32_t* S)
+{
+    const int b1 = At(B, 27), b2 = At(b1, 27), b3 = At(b2, 27), b4 = At(b3, 28);
+    S[At(B, 4)] ^= S[At(B, 0)];
+    S[At(B, 9)] ^= S[At(B, 0)];
+    S[At(B, 18)] ^= S[At(B, 0)];
+    S[At(B, 27)] ^= S[At(B, 0)];
+    SMix<b1>(S);
+    S[At(b1, 4)] ^= S[At(b1, 0)];
+    S[At(b1, 10)] ^= S[At(b1, 0)];
+    S[At(b1, 18)] ^= S[At(b1, 0)];
+    S[At(b1, 27)] ^= S[At(b1, 0)];
+    SMix<b2>(S);
+    S[At(b2, 4)] ^= S[At(b2, 0)];
+    S[At(b2, 10)] ^= S[At(b2, 0)];
+    S[At(b2, 19)] ^= S[At(b2, 0)];
+    S[At(b2, 27)] ^= S[At(b2, 0)];
+    SMix<b3>(S);
+    S[At(b3, 4)] ^= S[At(b3, 0)];
+    S[At(b3, 10)] ^= S[At(b3, 0)];
+    S[At(b3, 19)] ^= S[At(b3, 0)];
+    S[At(b3, 28)] ^= S[At(b3, 0)];
+    SMix<b4>(S);
+}
+
+} // namespace
+
+void Words(sph_fugue_context* sc, const void* data, size_t n)
+{
+    // The rotations of the state are only tracked, in round_shift, so the
+    // rounds for consecutive words find it at three different offsets.
+    uint32_t S[36];
+    memcpy(S, sc->S, sizeof(S));
+    unsigned rshift = sc->round_shift;
+    const unsigned char* in = (const unsigned char*)data;
+    for (; n > 0; --n, in += 4) {
+        const uint32_t p = ReadBE32(in);
+        if (rshift == 0) {
+            Round<0>(S, p);
+        } else if (rshift == 1) {
+            Round<24>(S, p);
+        } else {
+            Round<12>(S, p);
+        }
+        rshift = rshift == 2 ? 0 : rshift + 1;
+    }
+    memcpy(sc->S, S, sizeof(S));
+    sc->round_shift = rshift;
+}
+
+void Final(sph_u32* S)
+{
+    // 32 times ROR3, CMIX36 and SMIX
+    __m128i x = CMixSMix<33>(S);
+    x = CMixSMix<30>(S, x);
+    x = CMixSMix<27>(S, x);
+    x = CMixSMix<24>(S, x);
+    for (int i = 0; i < 2; ++i) {
+        x = SubRounds<24>(S, x);
+        x = SubRounds<12>(S, x);
+        x = SubRounds<0>(S, x);
+    }
+    SubRounds<24>(S, x);
+
+    // The state now starts at word 12. Rotate it back there after each
+    // iteration, rather than having 13 copies of the iteration.
+    for (int i = 0; i < 13; ++i) {
+        FinalRound<12>(S);
+        const uint32_t t = S[0];
+        memmove(S, S + 1, 35 * sizeof(uint32_t));
+        S[35] = t;
+    }
+    S[At(12, 4)] ^= S[At(12, 0)];
+    S[At(12, 9)] ^= S[At(12, 0)];
+    S[At(12, 18)] ^= S[At(12, 0)];
+    S[At(12, 27)] ^= S[At(12, 0)];
+
+    uint32_t T[36];
+    for (int i = 0; i < 36; ++i) {
+        T[i] = S[At(12, i)];
+    }
+    memcpy(S, T, sizeof(T));
+}
+
+} // namespace fugue_aesni
+
+namespace groestl_aesni {
+namespace {
+
+/** Load the 8x16 byte matrix, stored column by column, as one register per
+ *  row. ShiftBytes then only moves bytes within a register. */
+void inline LoadRows(const void* in, __m128i* A)
+{
+    const __m128i* p = (const __m128i*)in;
+    const __m128i interleave = _mm_setr_epi8(0, 8, 1, 9, 2, 10, 3, 11, 4, 12, 5, 13, 6, 14, 7, 15);
+    __m128i Y[8], L[4], H[4];
+    for (int k = 0; k < 8; ++k) {
+        // word r = row r of columns 2k and 2k+1
+        Y[k] = _mm_shuffle_epi8(_mm_loadu_si128(p + k), interleave);
+    }
+    for (int m = 0; m < 4; ++m) {
+        // dword r = row r (r + 4) of columns 4m..4m+3
+        L[m] = _mm_unpacklo_epi16(Y[2 * m], Y[2 * m + 1]);
+        H[m] = _mm_unpackhi_epi16(Y[2 * m], Y[2 * m + 1]);
+    }
+    for (int n = 0; n < 2; ++n) {
+        // qword r = row r of columns 8n..8n+7
+        Y[4 * n + 0] = _mm_unpacklo_epi32(L[2 * n], L[2 * n + 1]);
+        Y[4 * n + 1] = _mm_unpackhi_epi32(L[2 * n], L[2 * n + 1]);
+        Y[4 * n + 2] = _mm_unpacklo_epi32(H[2 * n], H[2 * n + 1]);
+        Y[4 * n + 3] = _mm_unpackhi_epi32(H[2 * n], H[2 * n + 1]);
+    }
+    for (int q = 0; q < 4; ++q) {
+        A[2 * q] = _mm_unpacklo_epi64(Y[q], Y[q + 4]);
+        A[2 * q + 1] = _mm_unpackhi_epi64(Y[q], Y[q + 4]);
+    }
+}
+
+/** The inverse of LoadRows() */
+void inline StoreRows(const __m128i* A, void* out)
+{
+    __m128i* p = (__m128i*)out;
+    __m128i U[8], V[8];
+    for (int k = 0; k < 4; ++k) {
+        // word c = rows 2k and 2k+1 of column c (c + 8)
+        U[2 * k] = _mm_unpacklo_epi8(A[2 * k], A[2 * k + 1]);
+        U[2 * k + 1] = _mm_unpackhi_epi8(A[2 * k], A[2 * k + 1]);
+    }
+    for (int k = 0; k < 2; ++k) {
+        // dword c = rows 4k..4k+3 of column c (c + 4, c + 8, c + 12)
+        V[4 * k + 0] = _mm_unpacklo_epi16(U[4 * k], U[4 * k + 2]);
+        V[4 * k + 1] = _mm_unpackhi_epi16(U[4 * k], U[4 * k + 2]);
+        V[4 * k + 2] = _mm_unpacklo_epi16(U[4 * k + 1], U[4 * k + 3]);
+        V[4 * k + 3] = _mm_unpackhi_epi16(U[4 * k + 1], U[4 * k + 3]);
+    }
+    for (int k = 0; k < 4; ++k) {
+        _mm_storeu_si128(p + 2 * k, _mm_unpacklo_epi32(V[k], V[k + 4]));
+        _mm_storeu_si128(p + 2 * k + 1, _mm_unpackhi_epi32(V[k], V[k + 4]));
+    }
+}
+
+/** ShiftBytes and SubBytes for a row rotated left by s bytes. aesenclast
+ *  with a zero key is SubBytes after AES ShiftRows, so the shuffle also
+ *  undoes ShiftRows. */
+template <int s>
+__m128i inline __attribute__((always_inline)) ShiftSub(__m128i x)
+{
+    const __m128i mask = _mm_setr_epi8((0 + s) & 15, (13 + s) & 15, (10 + s) & 15, (7 + s) & 15,
+                                       (4 + s) & 15, (1 + s) & 15, (14 + s) & 15, (11 + s) & 15,
+                                       (8 + s) & 15, (5 + s) & 15, (2 + s) & 15, (15 + s) & 15,
+                                       (12 + s) & 15, (9 + s) & 15, (6 + s) & 15, (3 + s) & 15);
+    return _mm_aesenclast_si128(_mm_shuffle_epi8(x, mask), _mm_setzero_si128());
+}
+
+/** Row i of MixBytes: 02 a[i] ^ 02 a[i+1] ^ 03 a[i+2] ^ 04 a[i+3] ^
+ *  05 a[i+4] ^ 03 a[i+5] ^ 05 a[i+6] ^ 07 a[i+7], split into the terms
+ *  multiplied by 1, 2 and 4. t[k] is a[k] ^ a[k+1]. */
+__m128i inline __attribute__((always_inline)) MixRow(__m128i a2, __m128i a5, __m128i a7, __m128i t0, __m128i t3, __m128i t4, __m128i t6)
+{
+    __m128i x4 = Xor(t3, t6);
+    __m128i x2 = Xor(Xor(t0, a2), Xor(a5, a7));
+    __m128i x1 = Xor(a2, Xor(t4, t6));
+    return Xor(x1, Mul2(Xor(x2, Mul2(x4))));
+}
+
+void inline __attribute__((always_inline)) MixBytes(__m128i* a)
+{
+    __m128i a0 = a[0], a1 = a[1], a2 = a[2], a3 = a[3], a4 = a[4], a5 = a[5], a6 = a[6], a7 = a[7];
+    __m128i t0 = Xor(a0, a1), t1 = Xor(a1, a2), t2 = Xor(a2, a3), t3 = Xor(a3, a4);
+    __m128i t4 = Xor(a4, a5), t5 = Xor(a5, a6), t6 = Xor(a6, a7), t7 = Xor(a7, a0);
+    a[0] = MixRow(a2, a5, a7, t0, t3, t4, t6);
+    a[1] = MixRow(a3, a6, a0, t1, t4, t5, t7);
+    a[2] = MixRow(a4, a7, a1, t2, t5, t6, t0);
+    a[3] = MixRow(a5, a0, a2, t3, t6, t7, t1);
+    a[4] = MixRow(a6, a1, a3, t4, t7, t0, t2);
+    a[5] = MixRow(a7, a2, a4, t5, t0, t1, t3);
+    a[6] = MixRow(a0, a3, a5, t6, t1, t2, t4);
+    a[7] = MixRow(a1, a4, a6, t7, t2, t3, t5);
+}
+
+/** Byte j of the column constants: j << 4 */
+__m128i inline ColumnConstants()
+{
+    return _mm_setr_epi8(0x00, 0x10, 0x20, 0x30, 0x40, 0x50, 0x60, 0x70,
+                         (char)0x80, (char)0x90, (char)0xA0, (char)0xB0, (char)0xC0, (char)0xD0, (char)0xE0, (char)0xF0);
+}
+
+void inline __attribute__((always_inline)) RoundP(__m128i* a, int r)
+{
+    a[0] = Xor(a[0], Xor(ColumnConstants(), _mm_set1_epi8(r)));
+    a[0] = ShiftSub<0>(a[0]);
+    a[1] = ShiftSub<1>(a[1]);
+    a[2] = ShiftSub<2>(a[2]);
+    a[3] = ShiftSub<3>(a[3]);
+    a[4] = ShiftSub<4>(a[4]);
+    a[5] = ShiftSub<5>(a[5]);
+    a[6] = ShiftSub<6>(a[6]);
+    a[7] = ShiftSub<11>(a[7]);
+    MixBytes(a);
+}
+
+void inline __attribute__((always_inline)) RoundQ(__m128i* a, int r)
+{
+    const __m128i ones = _mm_set1_epi8(-1);
+    for (int i = 0; i < 7; ++i) {
+        a[i] = Xor(a[i], ones);
+    }
+    a[7] = Xor(a[7], Xor(Xor(ColumnConstants(), ones), _mm_set1_epi8(r)));
+    a[0] = ShiftSub<1>(a[0]);
+    a[1] = ShiftSub<3>(a[1]);
+    a[2] = ShiftSub<5>(a[2]);
+    a[3] = ShiftSub<11>(a[3]);
+    a[4] = ShiftSub<0>(a[4]);
+    a[5] = ShiftSub<2>(a[5]);
+    a[6] = ShiftSub<4>(a[6]);
+    a[7] = ShiftSub<6>(a[7]);
+    MixBytes(a);
+}
+
+} // namespace
+
+void Compress(sph_groestl_big_context* sc)
+{
+    __m128i h[8], g[8], m[8];
+    LoadRows(sc->state.wide, h);
+    LoadRows(sc->buf, m);
+    for (int i = 0; i < 8; ++i) {
+        g[i] = Xor(h[i], m[i]);
+    }
+    for (int r = 0; r < 14; ++r) {
+        RoundP(g, r);
+        RoundQ(m, r);
+    }
+    for (int i = 0; i < 8; ++i) {
+        h[i] = Xor(h[i], Xor(g[i], m[i]));
+    }
+    StoreRows(h, sc->state.wide);
+}
+
+void Final(sph_groestl_big_context* sc)
+{
+    __m128i h[8], x[8];
+    LoadRows(sc->state.wide, h);
+    for (int i = 0; i < 8; ++i) {
+        x[i] = h[i];
+    }
+    for (int r = 0; r < 14; ++r) {
+        RoundP(x, r);
+    }
+    for (int i = 0; i < 8; ++i) {
+        h[i] = Xor(h[i], x[i]);
+    }
+    StoreRows(h, sc->state.wide);
+}
+
+} // namespace groestl_aesni
+
+namespace shavite_aesni {
+
+void Compress(sph_shavite_big_context* sc, const void* msg)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i* in = (const __m128i*)msg;
+
+    // Expand the message into 112 round keys of 128 bits. The counter is
+    // mixed into four of them, at the same words as the reference code.
+    __m128i rk[112];
+    for (int i = 0; i < 8; ++i) {
+        rk[i] = _mm_loadu_si128(in + i);
+    }
+    const __m128i ncount = _mm_set_epi32(~sc->count3, sc->count2, sc->count1, sc->count0);
+    int j = 8;
+    for (;;) {
+        for (int s = 0; s < 8; ++s, ++j) {
+            __m128i x = _mm_shuffle_epi32(rk[j - 8], _MM_SHUFFLE(0, 3, 2, 1));
+            rk[j] = _mm_xor_si128(_mm_aesenc_si128(x, zero), rk[j - 1]);
+            if (j == 8) {
+                rk[j] = _mm_xor_si128(rk[j], ncount);
+            } else if (j == 41) {
+                rk[j] = _mm_xor_si128(rk[j], _mm_set_epi32(~sc->count0, sc->count1, sc->count2, sc->count3));
+            } else if (j == 79) {
+                rk[j] = _mm_xor_si128(rk[j], _mm_set_epi32(~sc->count1, sc->count0, sc->count3, sc->count2));
+            } else if (j == 110) {
+                rk[j] = _mm_xor_si128(rk[j], _mm_set_epi32(~sc->count2, sc->count3, sc->count0, sc->count1));
+            }
+        }
+        if (j == 112)
+            break;
+        for (int s = 0; s < 8; ++s, ++j) {
+            rk[j] = _mm_xor_si128(rk[j - 8], _mm_alignr_epi8(rk[j - 1], rk[j - 2], 4));
+        }
+    }
+
+    __m128i p0 = _mm_loadu_si128((const __m128i*)&sc->h[0x0]);
+    __m128i p1 = _mm_loadu_si128((const __m128i*)&sc->h[0x4]);
+    __m128i p2 = _mm_loadu_si128((const __m128i*)&sc->h[0x8]);
+    __m128i p3 = _mm_loadu_si128((const __m128i*)&sc->h[0xC]);
+    const __m128i* k = rk;
+    for (int r = 0; r < 14; ++r) {
+        // Four AES rounds with the round keys xored in before each of them
+        __m128i x = _mm_xor_si128(p1, k[0]);
+        x = _mm_aesenc_si128(x, k[1]);
+        x = _mm_aesenc_si128(x, k[2]);
+        x = _mm_aesenc_si128(x, k[3]);
+        p0 = _mm_xor_si128(p0, _mm_aesenc_si128(x, zero));
+
+        x = _mm_xor_si128(p3, k[4]);
+        x = _mm_aesenc_si128(x, k[5]);
+        x = _mm_aesenc_si128(x, k[6]);
+        x = _mm_aesenc_si128(x, k[7]);
+        p2 = _mm_xor_si128(p2, _mm_aesenc_si128(x, zero));
+        k += 8;
+
+        __m128i t = p3;
+        p3 = p2;
+        p2 = p1;
+        p1 = p0;
+        p0 = t;
+    }
+
+    __m128i* h = (__m128i*)sc->h;
+    _mm_storeu_si128(h + 0, _mm_xor_si128(_mm_loadu_si128(h + 0), p0));
+    _mm_storeu_si128(h + 1, _mm_xor_si128(_mm_loadu_si128(h + 1), p1));
+    _mm_storeu_si128(h + 2, _mm_xor_si128(_mm_loadu_si128(h + 2), p2));
+    _mm_storeu_si128(h + 3, _mm_xor_si128(_mm_loadu_si128(h + 3), p3));
+}
+
+} // namespace shavite_aesni
+
+#endif
@@ -40,7 +40,7 @@ void CDSNotificationInterface::UpdatedBlockTip(const CBlockIndex *pindexNew, con
         return;
 
     mnodeman.UpdatedBlockTip(pindexNew);
-    infnodeman.UpdatedBlockTip(pindexNew);
+    infnodeman.UpdateChainTip(pindexNew);
     instantsend.UpdatedBlockTip(pindexNew);
     mnpayments.UpdatedBlockTip(pindexNew, connman);
     governance.UpdatedBlockTip(pindexNew, connman);
@@ -50,3 +50,15 @@ void CDSNotificationInterface::SyncTransaction(const CTransaction &tx, const CBl
 {
     instantsend.SyncTransaction(tx, pindex, posInBlock);
 }
+
+void CDSNotificationInterface::BlockConnected(const std::shared_ptr<const CBlock> &block, const CBlockIndex *pindex, const std::vector<CTransactionRef> &txnConflicted)
+{
+    mnodeman.InvalidateInfinityNodeInfo(*block);
+    mnodeman.UpdateLastPaidIndex(*block, pindex);
+}
+
+void CDSNotificationInterface::BlockDisconnected(const std::shared_ptr<const CBlock> &block)
+{
+    mnodeman.InvalidateInfinityNodeInfo(*block);
+    mnodeman.UndoLastPaidIndex(*block);
+}
@@ -0,0 +1,209 @@
+// Copyright (c) 2018-2019 SIN developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/infinitynodeindex.h>
+
+#include <chainparams.h>
+#include <crypto/common.h>
+#include <infinitynodeman.h>
+#include <util.h>
+#include <validation.h>
+
+constexpr char DB_BURNFUND = 'b';
+constexpr char DB_PAYEES = 'p';
+constexpr char DB_STATEMENT = 's';
+
+std::unique_ptr<InfinitynodeIndex> g_infinitynodeindex;
+
+namespace {
+
+/** A height in a database key, big endian so that keys sort by height */
+struct DBHeightKey
+{
+    int nHeight;
+
+    explicit DBHeightKey(int nHeightIn = 0) : nHeight(nHeightIn) {}
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        unsigned char buf[4];
+        WriteBE32(buf, nHeight);
+        s.write((const char*)buf, sizeof(buf));
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        unsigned char buf[4];
+        s.read((char*)buf, sizeof(buf));
+        nHeight = ReadBE32(buf);
+    }
+};
+
+/** A burn fund and the block it is in */
+struct CDiskInfinitynode
+{
+    uint256 hashBlock;
+    CInfinitynode node;
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action) {
+        READWRITE(hashBlock);
+        READWRITE(node);
+    }
+};
+
+/** The infinitynode payees of a block */
+struct CDiskInfinitynodePayees
+{
+    uint256 hashBlock;
+    std::vector<CScript> vPayees;
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action) {
+        READWRITE(hashBlock);
+        READWRITE(vPayees);
+    }
+};
+
+typedef std::pair<char, std::pair<unsigned char, DBHeightKey>> StatementKey;
+
+bool IsInActiveChain(const uint256& hashBlock, int nHeight)
+{
+    AssertLockHeld(cs_main);
+    const CBlockIndex* pindex = chainActive[nHeight];
+    return pindex && pindex->GetBlockHash() == hashBlock;
+}
+
+} // namespace
+
+/**
+ * Access to the infinitynode index database (indexes/infinitynodeindex/)
+ */
+class InfinitynodeIndex::DB : public BaseIndex::DB
+{
+public:
+    explicit DB(size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+};
+
+InfinitynodeIndex::DB::DB(size_t n_cache_size, bool f_memory, bool f_wipe) :
+    BaseIndex::DB(GetDataDir() / "indexes" / "infinitynodeindex", n_cache_size, f_memory, f_wipe)
+{}
+
+InfinitynodeIndex::InfinitynodeIndex(size_t n_cache_size, bool f_memory, bool f_wipe)
+    : m_db(MakeUnique<InfinitynodeIndex::DB>(n_cache_size, f_memory, f_wipe))
+{}
+
+InfinitynodeIndex::~InfinitynodeIndex() {}
+
+bool InfinitynodeIndex::WriteBlock(const CBlock& block, const CBlockIndex* pindex)
+{
+    if (pindex->nHeight < Params().GetConsensus().nInfinityNodeBeginHeight) {
+        return true;
+    }
+
+    std::vector<CInfinitynode> vNodes;
+    std::vector<CScript> vPayees;
+    if (!CInfinitynodeMan::getBlockInfinitynodes(block, pindex, vNodes, vPayees)) {
+        // only missing undo data fails here; the best block must not move
+        // past a block whose burn funds and payees were not written
+        return error("%s: cannot find infinitynodes of block %s", __func__, pindex->GetBlockHash().ToString());
+    }
+
+    CDBBatch batch(*m_db);
+    for (const CInfinitynode& node : vNodes) {
+        batch.Write(std::make_pair(DB_BURNFUND, node.vinBurnFund.prevout), CDiskInfinitynode{pindex->GetBlockHash(), node});
+    }
+    if (!vPayees.empty()) {
+        batch.Write(std::make_pair(DB_PAYEES, DBHeightKey(pindex->nHeight)), CDiskInfinitynodePayees{pindex->GetBlockHash(), vPayees});
+    }
+    return m_db->WriteBatch(batch);
+}
+
+BaseIndex::DB& InfinitynodeIndex::GetDB() const { return *m_db; }
+
+bool InfinitynodeIndex::ReadInfinitynodes(int nHeight, std::vector<CInfinitynode>& vNodes) const
+{
+    std::unique_ptr<CDBIterator> cursor(m_db->NewIterator());
+    LOCK(cs_main);
+    for (cursor->Seek(DB_BURNFUND); cursor->Valid(); cursor->Next()) {
+        std::pair<char, COutPoint> key;
+        if (!cursor->GetKey(key) || key.first != DB_BURNFUND) {
+            break;
+        }
+        CDiskInfinitynode value;
+        if (!cursor->GetValue(value)) {
+            return error("%s: cannot parse burn fund record", __func__);
+        }
+        if (value.node.getHeight() < nHeight && IsInActiveChain(value.hashBlock, value.node.getHeight())) {
+            vNodes.push_back(value.node);
+        }
+    }
+    return true;
+}
+
+bool InfinitynodeIndex::ReadLastPaid(int nFromHeight, int nHeight, std::map<CScript, int>& mapLastPaid) const
+{
+    std::unique_ptr<CDBIterator> cursor(m_db->NewIterator());
+    LOCK(cs_main);
+    for (cursor->Seek(std::make_pair(DB_PAYEES, DBHeightKey(std::max(nFromHeight, 0)))); cursor->Valid(); cursor->Next()) {
+        std::pair<char, DBHeightKey> key;
+        if (!cursor->GetKey(key) || key.first != DB_PAYEES || key.second.nHeight >= nHeight) {
+            break;
+        }
+        CDiskInfinitynodePayees value;
+        if (!cursor->GetValue(value)) {
+            return error("%s: cannot parse payee record", __func__);
+        }
+        if (!IsInActiveChain(value.hashBlock, key.second.nHeight)) {
+            continue;
+        }
+        // heights increase, so the last one seen is the last paid
+        for (const CScript& payee : value.vPayees) {
+            mapLastPaid[payee] = key.second.nHeight;
+        }
+    }
+    return true;
+}
+
+bool InfinitynodeIndex::ReadStatements(int nSinType, std::map<int, int>& mapStatement) const
+{
+    std::unique_ptr<CDBIterator> cursor(m_db->NewIterator());
+    for (cursor->Seek(StatementKey(DB_STATEMENT, {(unsigned char)nSinType, DBHeightKey(0)})); cursor->Valid(); cursor->Next()) {
+        StatementKey key;
+        if (!cursor->GetKey(key) || key.first != DB_STATEMENT || key.second.first != nSinType) {
+            break;
+        }
+        int nSize;
+        if (!cursor->GetValue(nSize)) {
+            return error("%s: cannot parse statement record", __func__);
+        }
+        mapStatement[key.second.second.nHeight] = nSize;
+    }
+    return true;
+}
+
+bool InfinitynodeIndex::WriteStatements(int nSinType, int nFromHeight, const std::map<int, int>& mapStatement)
+{
+    CDBBatch batch(*m_db);
+    std::unique_ptr<CDBIterator> cursor(m_db->NewIterator());
+    for (cursor->Seek(StatementKey(DB_STATEMENT, {(unsigned char)nSinType, DBHeightKey(std::max(nFromHeight, 0))})); cursor->Valid(); cursor->Next()) {
+        StatementKey key;
+        if (!cursor->GetKey(key) || key.first != DB_STATEMENT || key.second.first != nSinType) {
+            break;
+        }
+        if (!mapStatement.count(key.second.second.nHeight)) {
+            batch.Erase(key);
+        }
+    }
+    for (auto it = mapStatement.lower_bound(nFromHeight); it != mapStatement.end(); ++it) {
+        batch.Write(StatementKey(DB_STATEMENT, {(unsigned char)nSinType, DBHeightKey(it->first)}), it->second);
+    }
+    return m_db->WriteBatch(batch);
+}
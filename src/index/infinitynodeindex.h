@@ -0,0 +1,66 @@
+// Copyright (c) 2018-2019 SIN developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef SIN_INDEX_INFINITYNODEINDEX_H
+#define SIN_INDEX_INFINITYNODEINDEX_H
+
+#include <chain.h>
+#include <index/base.h>
+#include <infinitynode.h>
+
+static const bool DEFAULT_INFINITYNODEINDEX = true;
+//! max. -dbcache (MiB) for the infinitynode index
+static const int64_t nMaxInfinitynodeIndexCache = 16;
+
+/**
+ * InfinitynodeIndex keeps the on-chain infinitynode data, so the infinitynode
+ * list can be loaded at startup instead of being rescanned or restored from a
+ * full dump. It is written to a LevelDB database as blocks are connected and
+ * stores the burn funds by outpoint, the infinitynode payees by height and the
+ * reward statements by SIN type and height.
+ *
+ * Records of blocks that were later disconnected stay in the database; they
+ * hold the block hash and are skipped when they are not on the active chain.
+ */
+class InfinitynodeIndex final : public BaseIndex
+{
+protected:
+    class DB;
+
+private:
+    const std::unique_ptr<DB> m_db;
+
+protected:
+    bool WriteBlock(const CBlock& block, const CBlockIndex* pindex) override;
+
+    BaseIndex::DB& GetDB() const override;
+
+    const char* GetName() const override { return "infinitynodeindex"; }
+
+public:
+    /// Constructs the index, which becomes available to be queried.
+    explicit InfinitynodeIndex(size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    // Destructor is declared because this class contains a unique_ptr to an incomplete type.
+    virtual ~InfinitynodeIndex() override;
+
+    /// Read the burn funds of the active chain below height nHeight.
+    bool ReadInfinitynodes(int nHeight, std::vector<CInfinitynode>& vNodes) const;
+
+    /// Read the last paid height of the payees paid on the active chain from
+    /// height nFromHeight to below nHeight.
+    bool ReadLastPaid(int nFromHeight, int nHeight, std::map<CScript, int>& mapLastPaid) const;
+
+    /// Read the reward statements of a SIN type, as statement height to size.
+    bool ReadStatements(int nSinType, std::map<int, int>& mapStatement) const;
+
+    /// Replace the reward statements of a SIN type from height nFromHeight
+    /// on with the ones of mapStatement.
+    bool WriteStatements(int nSinType, int nFromHeight, const std::map<int, int>& mapStatement);
+};
+
+/// The global infinitynode index. May be null.
+extern std::unique_ptr<InfinitynodeIndex> g_infinitynodeindex;
+
+#endif // SIN_INDEX_INFINITYNODEINDEX_H
@@ -5,12 +5,19 @@
 #include <infinitynodeman.h>
 #include <util.h> //fMasterNode variable
 #include <chainparams.h>
+#include <checkqueue.h>
 #include <key_io.h>
 #include <util.h>
 #include <script/standard.h>
 #include <flat-database.h>
+#include <index/infinitynodeindex.h>
+#include <ui_interface.h>
+#include <undo.h>
 #include <utilstrencodings.h>
 
+#include <algorithm>
+#include <tuple>
+
 
 CInfinitynodeMan infnodeman;
 
@@ -36,15 +43,55 @@ struct CompareUnit256Value
 
 CInfinitynodeMan::CInfinitynodeMan()
 : cs(),
+  nCachedBlockHeight(0),
   mapInfinitynodes(),
+  nBIGLastStmHeight(0),
+  nMIDLastStmHeight(0),
+  nLILLastStmHeight(0),
+  nBIGLastStmSize(0),
+  nMIDLastStmSize(0),
+  nLILLastStmSize(0),
+  pindexListTip(nullptr),
+  snapshot(std::make_shared<CInfinitynodeSnapshot>()),
   nLastScanHeight(0)
 {}
 
+void CInfinitynodeMan::publishSnapshot()
+{
+    AssertLockHeld(cs);
+    std::shared_ptr<CInfinitynodeSnapshot> snap = std::make_shared<CInfinitynodeSnapshot>();
+    snap->mapInfinitynodes = mapInfinitynodes;
+    snap->mapInfinitynodesNonMatured = mapInfinitynodesNonMatured;
+    {
+        LOCK(cs_LastPaid);
+        snap->mapLastPaid = mapLastPaid;
+    }
+    snap->mapLastStatement[10] = std::make_pair(nBIGLastStmHeight, nBIGLastStmSize);
+    snap->mapLastStatement[5] = std::make_pair(nMIDLastStmHeight, nMIDLastStmSize);
+    snap->mapLastStatement[1] = std::make_pair(nLILLastStmHeight, nLILLastStmSize);
+    snap->nLastScanHeight = nLastScanHeight;
+    std::atomic_store(&snapshot, std::shared_ptr<const CInfinitynodeSnapshot>(std::move(snap)));
+}
+
 void CInfinitynodeMan::Clear()
 {
     LOCK(cs);
+    clear();
+    publishSnapshot();
+}
+
+void CInfinitynodeMan::clear()
+{
+    AssertLockHeld(cs);
+    for (auto& infpair : mapInfinitynodes) {
+        setStatementsDirty(infpair.second.getSINType(), infpair.second.getHeight());
+    }
     mapInfinitynodes.clear();
+    mapInfinitynodesNonMatured.clear();
     mapLastPaid.clear();
+    mapBlockUndo.clear();
+    clearNodeIndexes();
+    pindexListTip = nullptr;
     nLastScanHeight = 0;
 }
 
@@ -53,23 +100,47 @@ bool CInfinitynodeMan::Add(CInfinitynode &inf)
     LOCK(cs);
     if (Has(inf.vinBurnFund.prevout)) return false;
     mapInfinitynodes[inf.vinBurnFund.prevout] = inf;
+    setStatementsDirty(inf.getSINType(), inf.getHeight());
+    clearNodeIndexes();
     return true;
 }
 
 bool CInfinitynodeMan::AddUpdateLastPaid(CScript scriptPubKey, int nHeightLastPaid)
 {
-    LOCK(cs_LastPaid);
+    LOCK2(cs, cs_LastPaid);
     auto it = mapLastPaid.find(scriptPubKey);
-    if (it != mapLastPaid.end()) {
-        if (mapLastPaid[scriptPubKey] < nHeightLastPaid) {
-            mapLastPaid[scriptPubKey] = nHeightLastPaid;
-        }
-        return true;
+    if (it == mapLastPaid.end() || it->second < nHeightLastPaid) {
+        setLastPaid(scriptPubKey, nHeightLastPaid);
     }
-    mapLastPaid[scriptPubKey] = nHeightLastPaid;
     return true;
 }
 
+/**
+* Set the last paid height of a payee, -1 when it was never paid, and of the
+* matured nodes it belongs to
+*/
+void CInfinitynodeMan::setLastPaid(const CScript& payee, int nHeight)
+{
+    AssertLockHeld(cs);
+    AssertLockHeld(cs_LastPaid);
+    if (nHeight < 0)
+        mapLastPaid.erase(payee);
+    else
+        mapLastPaid[payee] = nHeight;
+
+    if (mapPayeeNodes.empty()) {
+        for (auto& infpair : mapInfinitynodes) {
+            mapPayeeNodes[infpair.second.getScriptPublicKey()].push_back(&infpair.second);
+        }
+    }
+    auto it = mapPayeeNodes.find(payee);
+    if (it != mapPayeeNodes.end()) {
+        for (CInfinitynode* pinf : it->second) {
+            pinf->setLastRewardHeight(nHeight);
+        }
+    }
+}
+
 CInfinitynode* CInfinitynodeMan::Find(const COutPoint &outpoint)
 {
     LOCK(cs);
@@ -118,7 +189,7 @@ std::string CInfinitynodeMan::ToString() const
     return info.str();
 }
 
-void CInfinitynodeMan::UpdatedBlockTip(const CBlockIndex *pindex)
+void CInfinitynodeMan::UpdateChainTip(const CBlockIndex *pindex)
 {
     nCachedBlockHeight = pindex->nHeight;
     if(fMasterNode) {
@@ -140,29 +211,35 @@ void CInfinitynodeMan::CheckAndRemove(CConnman& connman)
         return;
     }
 
-    //2nd scan and loop
-    if (nCachedBlockHeight > nLastScanHeight && nLastScanHeight > 0)
+    //2nd scan and loop, only while blocks are not being added as they are connected
+    if ((!pindexListTip || pindexListTip->nHeight < nCachedBlockHeight) && nLastScanHeight > 0)
     {
         LogPrint(BCLog::INFINITYNODE, "CInfinitynodeMan::CheckAndRemove -- block height %d and lastScan %d\n", 
                    nCachedBlockHeight, nLastScanHeight);
         buildInfinitynodeList(nCachedBlockHeight, nLastScanHeight);
     }
 
+    bool fUpdated = false;
     if (nBIGLastStmHeight + nBIGLastStmSize - nCachedBlockHeight < INF_MATURED_LIMIT){
         //calcul new Statement
         deterministicRewardStatement(10);
         //update rank for new Statement
-        calculInfinityNodeRank(nBIGLastStmHeight, 10, true);
+        calculInfinityNodeRank(nBIGLastStmHeight, 10);
+        fUpdated = true;
     }
     if (nMIDLastStmHeight + nMIDLastStmSize - nCachedBlockHeight < INF_MATURED_LIMIT){
         deterministicRewardStatement(5);
-        calculInfinityNodeRank(nMIDLastStmHeight, 5, true);
+        calculInfinityNodeRank(nMIDLastStmHeight, 5);
+        fUpdated = true;
     }
     if (nLILLastStmHeight + nLILLastStmSize - nCachedBlockHeight < INF_MATURED_LIMIT){
         deterministicRewardStatement(1);
-        calculInfinityNodeRank(nLILLastStmHeight, 1, true);
+        calculInfinityNodeRank(nLILLastStmHeight, 1);
+        fUpdated = true;
     }
 
+    if (fUpdated)
+        publishSnapshot();
     return;
 }
 
@@ -187,6 +264,51 @@ bool CInfinitynodeMan::initialInfinitynodeList(int nBlockHeight)
     return buildInfinitynodeList(nBlockHeight, Params().GetConsensus().nInfinityNodeBeginHeight);
 }
 
+bool CInfinitynodeMan::loadFromIndex(int nBlockHeight)
+{
+    LOCK(cs);
+    clear();
+    if (!g_infinitynodeindex || nBlockHeight < Params().GetConsensus().nInfinityNodeBeginHeight) return false;
+
+    // the index has the matured part of the list, the rest is rescanned to
+    // get the undo data for reorgs
+    int nScanHeight = max(Params().GetConsensus().nInfinityNodeBeginHeight, nBlockHeight - INF_MATURED_LIMIT);
+    if (nScanHeight == Params().GetConsensus().nInfinityNodeBeginHeight)
+        return buildInfinitynodeList(nBlockHeight, nScanHeight);
+
+    std::vector<CInfinitynode> vNodes;
+    std::map<CScript, int> mapLastPaidIndex;
+    int nLastPaidScanDeepth = max(Params().GetConsensus().nLimitSINNODE_1, max(Params().GetConsensus().nLimitSINNODE_5, Params().GetConsensus().nLimitSINNODE_10));
+    if (!g_infinitynodeindex->ReadInfinitynodes(nScanHeight, vNodes) ||
+        !g_infinitynodeindex->ReadLastPaid(nBlockHeight - nLastPaidScanDeepth, nScanHeight, mapLastPaidIndex) ||
+        !g_infinitynodeindex->ReadStatements(10, mapStatementBIG) ||
+        !g_infinitynodeindex->ReadStatements(5, mapStatementMID) ||
+        !g_infinitynodeindex->ReadStatements(1, mapStatementLIL)) {
+        LogPrintf("CInfinitynodeMan::loadFromIndex -- can not read infinitynode index\n");
+        Clear();
+        return false;
+    }
+    for (const CInfinitynode& inf : vNodes) {
+        mapInfinitynodes[inf.vinBurnFund.prevout] = inf;
+    }
+    {
+        LOCK(cs_LastPaid);
+        mapLastPaid.insert(mapLastPaidIndex.begin(), mapLastPaidIndex.end());
+    }
+    if (!mapStatementBIG.empty()) std::tie(nBIGLastStmHeight, nBIGLastStmSize) = *mapStatementBIG.rbegin();
+    if (!mapStatementMID.empty()) std::tie(nMIDLastStmHeight, nMIDLastStmSize) = *mapStatementMID.rbegin();
+    if (!mapStatementLIL.empty()) std::tie(nLILLastStmHeight, nLILLastStmSize) = *mapStatementLIL.rbegin();
+    // nodes burnt up to INF_MATURED_LIMIT blocks before the last statement
+    // may have matured after the statements were written
+    if (!mapStatementBIG.empty()) setStatementsDirty(10, nBIGLastStmHeight - INF_MATURED_LIMIT);
+    if (!mapStatementMID.empty()) setStatementsDirty(5, nMIDLastStmHeight - INF_MATURED_LIMIT);
+    if (!mapStatementLIL.empty()) setStatementsDirty(1, nLILLastStmHeight - INF_MATURED_LIMIT);
+
+    LogPrintf("CInfinitynodeMan::loadFromIndex -- loaded %d nodes below height %d\n", mapInfinitynodes.size(), nScanHeight);
+    nLastScanHeight = nScanHeight;
+    return buildInfinitynodeList(nBlockHeight, nLastScanHeight);
+}
+
 bool CInfinitynodeMan::updateInfinitynodeList(int nBlockHeight)
 {
     LogPrintf("CInfinitynodeMan::updateInfinitynodeList -- begin at %d...\n", nBlockHeight);
@@ -205,10 +327,12 @@ bool CInfinitynodeMan::buildInfinitynodeList(int nBlockHeight, int nLowHeight)
     assert(nBlockHeight >= nLowHeight);
     AssertLockHeld(cs);
     mapInfinitynodesNonMatured.clear();
+    mapBlockUndo.clear();
+    pindexListTip = nullptr;
 
     //first run, make sure that all variable is clear
     if (nLowHeight == Params().GetConsensus().nInfinityNodeBeginHeight){
-        Clear();
+        clear();
     } else {
         nLowHeight = nLastScanHeight;
     }
@@ -221,111 +345,413 @@ bool CInfinitynodeMan::buildInfinitynodeList(int nBlockHeight, int nLowHeight)
 
     CBlockIndex* pindex;
     pindex = LookupBlockIndex(blockHash);
-    CBlockIndex* prevBlockIndex = pindex;
-    int nLastPaidScanDeepth = max(Params().GetConsensus().nLimitSINNODE_1, max(Params().GetConsensus().nLimitSINNODE_5, Params().GetConsensus().nLimitSINNODE_10));
-    while (prevBlockIndex->nHeight >= nLowHeight)
+
+    // scan oldest block first, as if the blocks were connected one by one
+    std::vector<const CBlockIndex*> vScanIndex;
+    for (const CBlockIndex* prevBlockIndex = pindex; prevBlockIndex && prevBlockIndex->nHeight >= nLowHeight; prevBlockIndex = prevBlockIndex->pprev)
+        vScanIndex.push_back(prevBlockIndex);
+    std::reverse(vScanIndex.begin(), vScanIndex.end());
+    int nThreads = std::max(1, nScriptCheckThreads);
+
+    // blocks are read and scanned on the -par threads a chunk at a time, then
+    // added to the list in height order
+    const size_t nChunkSize = INF_SCAN_CHUNK_SIZE * nThreads;
+    const bool fReportProgress = vScanIndex.size() > nChunkSize;
+    std::vector<CInfinitynodeBlockScan> vScan;
+    for (size_t nBegin = 0; nBegin < vScanIndex.size(); nBegin += nChunkSize)
     {
-        CBlock blockReadFromDisk;
-        if (ReadBlockFromDisk(blockReadFromDisk, prevBlockIndex, Params().GetConsensus()))
-        {
-            for (const CTransactionRef& tx : blockReadFromDisk.vtx) {
-                //Not coinbase
-                if (!tx->IsCoinBase()) {
-                    for (unsigned int i = 0; i < tx->vout.size(); i++) {
-                        const CTxOut& out = tx->vout[i];
-                        std::vector<std::vector<unsigned char>> vSolutions;
-                        txnouttype whichType;
-                        const CScript& prevScript = out.scriptPubKey;
-                        Solver(prevScript, whichType, vSolutions);
-                        //Send to BurnAddress
-                        if (whichType == TX_BURN_DATA && Params().GetConsensus().cBurnAddress == EncodeDestination(CKeyID(uint160(vSolutions[0]))))
-                        {
-                            //Amount for InfnityNode
-                            if (
-                            ((Params().GetConsensus().nMasternodeBurnSINNODE_1 - 1) * COIN < out.nValue && out.nValue <= Params().GetConsensus().nMasternodeBurnSINNODE_1 * COIN) ||
-                            ((Params().GetConsensus().nMasternodeBurnSINNODE_5 - 1) * COIN < out.nValue && out.nValue <= Params().GetConsensus().nMasternodeBurnSINNODE_5 * COIN) ||
-                            ((Params().GetConsensus().nMasternodeBurnSINNODE_10 - 1) * COIN < out.nValue && out.nValue <= Params().GetConsensus().nMasternodeBurnSINNODE_10 * COIN)
-                            ) {
-                                COutPoint outpoint(tx->GetHash(), i);
-                                CInfinitynode inf(PROTOCOL_VERSION, outpoint);
-                                inf.setHeight(prevBlockIndex->nHeight);
-                                inf.setBurnValue(out.nValue);
-                                inf.setScriptPublicKey(prevScript);
-                                if (vSolutions.size() == 2){
-                                    std::string backupAddress(vSolutions[1].begin(), vSolutions[1].end());
-                                    inf.setBackupAddress(backupAddress);
-                                }
-                                //SINType
-                                CAmount nBurnAmount = out.nValue / COIN + 1; //automaticaly round
-                                inf.setSINType(nBurnAmount / 100000);
-                                //Address payee: we known that there is only 1 input
-                                const CTxIn& txin = tx->vin[0];
-                                int index = txin.prevout.n;
-
-                                CTransactionRef prevtx;
-                                uint256 hashblock;
-                                if(!GetTransaction(txin.prevout.hash, prevtx, Params().GetConsensus(), hashblock, false)) {
-                                    LogPrintf("CInfinitynodeMan::updateInfinityNodeInfo -- PrevBurnFund tx is not in block.\n");
-                                    return false;
-                                }
-
-                                CTxDestination addressBurnFund;
-                                if(!ExtractDestination(prevtx->vout[index].scriptPubKey, addressBurnFund)){
-                                    LogPrintf("CInfinitynodeMan::updateInfinityNodeInfo -- False when extract payee from BurnFund tx.\n");
-                                    return false;
-                                }
-                                inf.setCollateralAddress(EncodeDestination(addressBurnFund));
-                                //we have all infos. Then add in map
-                                if(prevBlockIndex->nHeight < pindex->nHeight - INF_MATURED_LIMIT) {
-                                    //matured
-                                    Add(inf);
-                                } else {
-                                    //non matured
-                                    mapInfinitynodesNonMatured[inf.vinBurnFund.prevout] = inf;
-                                }
-                            }
-                        }
-                        //Amount to update Metadata
-                        if (whichType == TX_BURN_DATA && Params().GetConsensus().cMetadataAddress == EncodeDestination(CKeyID(uint160(vSolutions[0]))))
-                        {
+        size_t nEnd = std::min(vScanIndex.size(), nBegin + nChunkSize);
+        if (!scanBlocks(vScanIndex, nBegin, nEnd, vScan))
+            return false;
+        addScannedBlocks(vScanIndex, nBegin, vScan, pindex);
+        if (fReportProgress) {
+            uiInterface.InitMessage(strprintf(_("Scanning blocks for infinitynodes... (%d%%)"), nEnd * 100 / vScanIndex.size()));
+        }
+    }
+
+    setListTip(pindex);
+
+    // the infinitynode index keeps the list on disk block by block
+    if (!g_infinitynodeindex) {
+        CFlatDB<CInfinitynodeMan> flatdb5("infinitynode.dat", "magicInfinityNodeCache");
+        flatdb5.Dump(infnodeman);
+    }
+
+    publishSnapshot();
+    LogPrintf("CInfinitynodeMan::buildInfinitynodeList -- list infinity node was built from blockchain and has %d nodes\n", Count());
+    return true;
+}
+
+/**
+* Add the scanned blocks vScanIndex[nBegin, nBegin + vScan.size()) to a list
+* being built up to pindexTip
+*/
+void CInfinitynodeMan::addScannedBlocks(const std::vector<const CBlockIndex*>& vScanIndex, size_t nBegin, const std::vector<CInfinitynodeBlockScan>& vScan, const CBlockIndex* pindexTip)
+{
+    AssertLockHeld(cs);
+    int nLastPaidScanDeepth = max(Params().GetConsensus().nLimitSINNODE_1, max(Params().GetConsensus().nLimitSINNODE_5, Params().GetConsensus().nLimitSINNODE_10));
+    for (size_t i = 0; i < vScan.size(); ++i) {
+        const CBlockIndex* pindexScan = vScanIndex[nBegin + i];
+        CInfinitynodeBlockUndo undo;
+        addBlockInfinitynodes(pindexScan, vScan[i].vNodes, vScan[i].vPayees, pindexScan->nHeight >= pindexTip->nHeight - nLastPaidScanDeepth, undo);
+        if (pindexScan->nHeight > pindexTip->nHeight - INF_MATURED_LIMIT)
+            mapBlockUndo[pindexScan->GetBlockHash()] = std::move(undo);
+    }
+}
+
+/**
+* Make the list built up to pindex current: mature its nodes and set their
+* last paid heights
+*/
+void CInfinitynodeMan::setListTip(const CBlockIndex* pindex)
+{
+    AssertLockHeld(cs);
+    updateMaturity(pindex->nHeight);
+    nLastScanHeight = pindex->nHeight - INF_MATURED_LIMIT;
+    pindexListTip = pindex;
+    updateLastPaid();
+}
+
+/**
+* Find the burn funds and the infinitynode payees of a block
+*/
+bool CInfinitynodeMan::getBlockInfinitynodes(const CBlock& block, const CBlockIndex* pindex, std::vector<CInfinitynode>& vNodesRet, std::vector<CScript>& vPayeesRet)
+{
+    // the outputs the burn txs spend, read once the block has a burn fund
+    CBlockUndo blockUndo;
+    bool fHaveUndo = false;
+    //block payment value, the same for every coinbase output
+    const CAmount nNodePaymentSINNODE_1 = GetMasternodePayment(pindex->nHeight, 1);
+    const CAmount nNodePaymentSINNODE_5 = GetMasternodePayment(pindex->nHeight, 5);
+    const CAmount nNodePaymentSINNODE_10 = GetMasternodePayment(pindex->nHeight, 10);
+
+    for (size_t nTx = 0; nTx < block.vtx.size(); nTx++) {
+        const CTransactionRef& tx = block.vtx[nTx];
+        //Not coinbase
+        if (!tx->IsCoinBase()) {
+            for (unsigned int i = 0; i < tx->vout.size(); i++) {
+                const CTxOut& out = tx->vout[i];
+                std::vector<std::vector<unsigned char>> vSolutions;
+                txnouttype whichType;
+                const CScript& prevScript = out.scriptPubKey;
+                Solver(prevScript, whichType, vSolutions);
+                //Send to BurnAddress
+                if (whichType == TX_BURN_DATA && Params().GetConsensus().cBurnAddress == EncodeDestination(CKeyID(uint160(vSolutions[0]))))
+                {
+                    //Amount for InfnityNode
+                    if (
+                    ((Params().GetConsensus().nMasternodeBurnSINNODE_1 - 1) * COIN < out.nValue && out.nValue <= Params().GetConsensus().nMasternodeBurnSINNODE_1 * COIN) ||
+                    ((Params().GetConsensus().nMasternodeBurnSINNODE_5 - 1) * COIN < out.nValue && out.nValue <= Params().GetConsensus().nMasternodeBurnSINNODE_5 * COIN) ||
+                    ((Params().GetConsensus().nMasternodeBurnSINNODE_10 - 1) * COIN < out.nValue && out.nValue <= Params().GetConsensus().nMasternodeBurnSINNODE_10 * COIN)
+                    ) {
+                        COutPoint outpoint(tx->GetHash(), i);
+                        CInfinitynode inf(PROTOCOL_VERSION, outpoint);
+                        inf.setHeight(pindex->nHeight);
+                        inf.setBurnValue(out.nValue);
+                        inf.setScriptPublicKey(prevScript);
+                        if (vSolutions.size() == 2){
+                            std::string backupAddress(vSolutions[1].begin(), vSolutions[1].end());
+                            inf.setBackupAddress(backupAddress);
                         }
-                    } //end loop for all output
-                } else { //Coinbase tx => update mapLastPaid
-                    if (prevBlockIndex->nHeight >= pindex->nHeight - nLastPaidScanDeepth){
-                        //block payment value
-                        CAmount nNodePaymentSINNODE_1 = GetMasternodePayment(prevBlockIndex->nHeight, 1);
-                        CAmount nNodePaymentSINNODE_5 = GetMasternodePayment(prevBlockIndex->nHeight, 5);
-                        CAmount nNodePaymentSINNODE_10 = GetMasternodePayment(prevBlockIndex->nHeight, 10);
-                        //compare and update map
-                        for (auto txout : blockReadFromDisk.vtx[0]->vout)
-                        {
-                            if (txout.nValue == nNodePaymentSINNODE_1 || txout.nValue == nNodePaymentSINNODE_5 ||
-                                txout.nValue == nNodePaymentSINNODE_10)
-                            {
-                                AddUpdateLastPaid(txout.scriptPubKey, prevBlockIndex->nHeight);
+                        //SINType
+                        CAmount nBurnAmount = out.nValue / COIN + 1; //automaticaly round
+                        inf.setSINType(nBurnAmount / 100000);
+                        //Address payee: we known that there is only 1 input
+                        if (!fHaveUndo) {
+                            if (!UndoReadFromDisk(blockUndo, pindex) || blockUndo.vtxundo.size() + 1 != block.vtx.size()) {
+                                LogPrintf("CInfinitynodeMan::getBlockInfinitynodes -- can not read undo data of block %s.\n", pindex->GetBlockHash().ToString());
+                                return false;
                             }
+                            fHaveUndo = true;
+                        }
+                        const CTxOut& prevout = blockUndo.vtxundo[nTx - 1].vprevout[0].out;
+
+                        // a nonstandard or bare multisig collateral has no
+                        // address to pay, so it can not be an infinitynode
+                        CTxDestination addressBurnFund;
+                        if(!ExtractDestination(prevout.scriptPubKey, addressBurnFund)){
+                            LogPrintf("CInfinitynodeMan::getBlockInfinitynodes -- skip burn fund %s, can not extract payee from its input.\n", outpoint.ToStringShort());
+                            continue;
                         }
+                        inf.setCollateralAddress(EncodeDestination(addressBurnFund));
+                        //we have all infos
+                        vNodesRet.push_back(inf);
                     }
                 }
+                //Amount to update Metadata
+                if (whichType == TX_BURN_DATA && Params().GetConsensus().cMetadataAddress == EncodeDestination(CKeyID(uint160(vSolutions[0]))))
+                {
+                }
+            } //end loop for all output
+        } else { //Coinbase tx => payees for mapLastPaid
+            //compare
+            for (const auto& txout : tx->vout)
+            {
+                if (txout.nValue == nNodePaymentSINNODE_1 || txout.nValue == nNodePaymentSINNODE_5 ||
+                    txout.nValue == nNodePaymentSINNODE_10)
+                {
+                    vPayeesRet.push_back(txout.scriptPubKey);
+                }
             }
-        } else {
-            LogPrint(BCLog::INFINITYNODE, "CInfinitynodeMan::buildInfinitynodeList -- can not read block from disk\n");
+        }
+    }
+    return true;
+}
+
+/** Closure representing the read and scan of one block for its burn funds and payees */
+class CInfinitynodeScanCheck
+{
+private:
+    const CBlockIndex *pindex;
+    CInfinitynodeBlockScan *pscan;
+
+public:
+    CInfinitynodeScanCheck(): pindex(nullptr), pscan(nullptr) {}
+    CInfinitynodeScanCheck(const CBlockIndex* pindexIn, CInfinitynodeBlockScan& scanIn) :
+        pindex(pindexIn), pscan(&scanIn) {}
+
+    bool operator()() {
+        CBlock block;
+        if (!ReadBlockFromDisk(block, pindex, Params().GetConsensus())) {
+            LogPrint(BCLog::INFINITYNODE, "CInfinitynodeMan::scanBlocks -- can not read block from disk\n");
             return false;
         }
-        // continue with previous block
-        prevBlockIndex = prevBlockIndex->pprev;
+        return CInfinitynodeMan::getBlockInfinitynodes(block, pindex, pscan->vNodes, pscan->vPayees);
     }
 
-    nLastScanHeight = nBlockHeight - INF_MATURED_LIMIT;
-    updateLastPaid();
+    void swap(CInfinitynodeScanCheck& check) {
+        std::swap(pindex, check.pindex);
+        std::swap(pscan, check.pscan);
+    }
+};
 
-    CFlatDB<CInfinitynodeMan> flatdb5("infinitynode.dat", "magicInfinityNodeCache");
-    flatdb5.Dump(infnodeman);
+// blocks are handed out in small batches as their size varies a lot
+static CCheckQueue<CInfinitynodeScanCheck> infinitynodescanqueue(16);
 
-    LogPrintf("CInfinitynodeMan::buildInfinitynodeList -- list infinity node was built from blockchain and has %d nodes\n", Count());
+void ThreadInfinitynodeScan() {
+    RenameThread("sin-infscan");
+    infinitynodescanqueue.Thread();
+}
+
+/**
+* Read the blocks vScanIndex[nBegin, nEnd) from disk and find their burn
+* funds and payees, on the -par script check threads. vScanRet[i] holds the
+* result for vScanIndex[nBegin + i].
+*/
+bool CInfinitynodeMan::scanBlocks(const std::vector<const CBlockIndex*>& vScanIndex, size_t nBegin, size_t nEnd, std::vector<CInfinitynodeBlockScan>& vScanRet)
+{
+    vScanRet.clear();
+    vScanRet.resize(nEnd - nBegin);
+
+    std::vector<CInfinitynodeScanCheck> vChecks;
+    vChecks.reserve(nEnd - nBegin);
+    for (size_t i = nBegin; i < nEnd; ++i) {
+        vChecks.emplace_back(vScanIndex[i], vScanRet[i - nBegin]);
+    }
+
+    CCheckQueueControl<CInfinitynodeScanCheck> control(&infinitynodescanqueue);
+    control.Add(vChecks);
+    return control.Wait();
+}
+
+/**
+* Add what getBlockInfinitynodes() found in the block at pindex to the list
+*/
+void CInfinitynodeMan::addBlockInfinitynodes(const CBlockIndex* pindex, const std::vector<CInfinitynode>& vNodes, const std::vector<CScript>& vPayees, bool fLastPaid, CInfinitynodeBlockUndo& undo)
+{
+    AssertLockHeld(cs);
+    undo.nHeight = pindex->nHeight;
+
+    for (const CInfinitynode& inf : vNodes) {
+        //add in map, it matures in updateMaturity
+        const COutPoint& outpoint = inf.vinBurnFund.prevout;
+        if (!Has(outpoint) && mapInfinitynodesNonMatured.emplace(outpoint, inf).second)
+            undo.vAddedNodes.push_back(outpoint);
+    }
+
+    if (!fLastPaid)
+        return;
+    LOCK(cs_LastPaid);
+    for (const CScript& payee : vPayees) {
+        auto it = mapLastPaid.find(payee);
+        undo.vLastPaidBefore.emplace_back(payee, it == mapLastPaid.end() ? -1 : it->second);
+        AddUpdateLastPaid(payee, pindex->nHeight);
+    }
+}
+
+/**
+* Revert addBlockInfinitynodes(). Payees are restored newest change first, so a
+* payee paid twice by the block gets its height from before the block.
+*/
+void CInfinitynodeMan::disconnectBlock(const CInfinitynodeBlockUndo& undo)
+{
+    AssertLockHeld(cs);
+    for (const COutPoint& outpoint : undo.vAddedNodes) {
+        auto it = mapInfinitynodes.find(outpoint);
+        if (it != mapInfinitynodes.end()) {
+            setStatementsDirty(it->second.getSINType(), it->second.getHeight());
+            mapInfinitynodes.erase(it);
+            clearNodeIndexes();
+        }
+        mapInfinitynodesNonMatured.erase(outpoint);
+    }
+
+    LOCK(cs_LastPaid);
+    for (auto it = undo.vLastPaidBefore.rbegin(); it != undo.vLastPaidBefore.rend(); ++it) {
+        setLastPaid(it->first, it->second);
+    }
+}
+
+/**
+* Move nodes between the matured and non matured maps for the list at
+* nTipHeight: a node is matured once it is INF_MATURED_LIMIT blocks deep.
+*/
+void CInfinitynodeMan::updateMaturity(int nTipHeight)
+{
+    AssertLockHeld(cs);
+    for (auto it = mapInfinitynodesNonMatured.begin(); it != mapInfinitynodesNonMatured.end();) {
+        if (it->second.getHeight() < nTipHeight - INF_MATURED_LIMIT) {
+            LOCK(cs_LastPaid);
+            auto itPaid = mapLastPaid.find(it->second.getScriptPublicKey());
+            it->second.setLastRewardHeight(itPaid != mapLastPaid.end() ? itPaid->second : -1);
+            mapInfinitynodes.emplace(it->first, it->second);
+            setStatementsDirty(it->second.getSINType(), it->second.getHeight());
+            clearNodeIndexes();
+            it = mapInfinitynodesNonMatured.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (auto it = mapInfinitynodes.begin(); it != mapInfinitynodes.end();) {
+        if (it->second.getHeight() >= nTipHeight - INF_MATURED_LIMIT) {
+            mapInfinitynodesNonMatured.emplace(it->first, it->second);
+            setStatementsDirty(it->second.getSINType(), it->second.getHeight());
+            clearNodeIndexes();
+            it = mapInfinitynodes.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void CInfinitynodeMan::BlockConnected(const std::shared_ptr<const CBlock>& pblock, const CBlockIndex* pindex, const std::vector<CTransactionRef>& vtxConflicted)
+{
+    LOCK(cs);
+    // not built yet, or behind: CheckAndRemove catches up from disk
+    if (!pindexListTip || pindex->pprev != pindexListTip)
+        return;
+
+    std::vector<CInfinitynode> vNodes;
+    std::vector<CScript> vPayees;
+    if (!getBlockInfinitynodes(*pblock, pindex, vNodes, vPayees)) {
+        LogPrintf("CInfinitynodeMan::BlockConnected -- can not add block %s, list will be rescanned\n", pindex->GetBlockHash().ToString());
+        pindexListTip = nullptr;
+        return;
+    }
+    connectTip(pindex, vNodes, vPayees);
+}
+
+/**
+* Add what getBlockInfinitynodes() found in the block at pindex, the child of
+* the list tip, keeping its undo data for INF_MATURED_LIMIT blocks
+*/
+void CInfinitynodeMan::connectTip(const CBlockIndex* pindex, const std::vector<CInfinitynode>& vNodes, const std::vector<CScript>& vPayees)
+{
+    AssertLockHeld(cs);
+    CInfinitynodeBlockUndo undo;
+    addBlockInfinitynodes(pindex, vNodes, vPayees, true, undo);
+    mapBlockUndo[pindex->GetBlockHash()] = std::move(undo);
+    for (auto it = mapBlockUndo.begin(); it != mapBlockUndo.end();) {
+        if (it->second.nHeight <= pindex->nHeight - INF_MATURED_LIMIT)
+            it = mapBlockUndo.erase(it);
+        else
+            ++it;
+    }
+
+    updateMaturity(pindex->nHeight);
+    nLastScanHeight = pindex->nHeight - INF_MATURED_LIMIT;
+    pindexListTip = pindex;
+    publishSnapshot();
+}
+
+void CInfinitynodeMan::BlockDisconnected(const std::shared_ptr<const CBlock>& pblock)
+{
+    LOCK(cs);
+    if (!pindexListTip || pindexListTip->GetBlockHash() != pblock->GetHash())
+        return;
+
+    disconnectTip();
+}
+
+/**
+* Remove the list tip block with its undo data. Deeper than the undo data we
+* keep, the list is cleared and rebuilt from scratch instead.
+*/
+bool CInfinitynodeMan::disconnectTip()
+{
+    AssertLockHeld(cs);
+    auto it = mapBlockUndo.find(pindexListTip->GetBlockHash());
+    if (it == mapBlockUndo.end()) {
+        LogPrintf("CInfinitynodeMan::disconnectTip -- no undo data for block %s, list will be rebuilt\n", pindexListTip->GetBlockHash().ToString());
+        Clear();
+        return false;
+    }
+    disconnectBlock(it->second);
+    mapBlockUndo.erase(it);
+
+    pindexListTip = pindexListTip->pprev;
+    updateMaturity(pindexListTip->nHeight);
+    nLastScanHeight = pindexListTip->nHeight - INF_MATURED_LIMIT;
+    publishSnapshot();
     return true;
 }
 
+void CInfinitynodeMan::syncToChainTip()
+{
+    // cs before cs_main, as in buildInfinitynodeList(). cs_main is only held
+    // to find the next block: blocks connected meanwhile are notified to
+    // BlockConnected(), which waits for cs and skips the ones done here.
+    LOCK(cs);
+    while (pindexListTip) {
+        const CBlockIndex* pindexNext;
+        bool fOnChain;
+        {
+            LOCK(cs_main);
+            fOnChain = chainActive.Contains(pindexListTip);
+            pindexNext = fOnChain ? chainActive.Next(pindexListTip) : nullptr;
+        }
+        if (!fOnChain) {
+            if (!disconnectTip())
+                return;
+            continue;
+        }
+        if (!pindexNext)
+            return;
+
+        CBlock block;
+        std::vector<CInfinitynode> vNodes;
+        std::vector<CScript> vPayees;
+        if (!ReadBlockFromDisk(block, pindexNext, Params().GetConsensus()) ||
+            !getBlockInfinitynodes(block, pindexNext, vNodes, vPayees)) {
+            LogPrintf("CInfinitynodeMan::syncToChainTip -- can not add block %s, list will be rescanned\n", pindexNext->GetBlockHash().ToString());
+            pindexListTip = nullptr;
+            return;
+        }
+        connectTip(pindexNext, vNodes, vPayees);
+    }
+}
+
+/**
+* Redo the statements of nSinType starting after nHeight, when a node burnt
+* at nHeight is added to or removed from the matured nodes
+*/
+void CInfinitynodeMan::setStatementsDirty(int nSinType, int nHeight)
+{
+    AssertLockHeld(cs);
+    auto it = mapStatementDirtyHeight.emplace(nSinType, nHeight).first;
+    it->second = std::min(it->second, nHeight);
+}
+
 void CInfinitynodeMan::updateLastPaid()
 {
     AssertLockHeld(cs);
@@ -335,57 +761,68 @@ void CInfinitynodeMan::updateLastPaid()
 
     for (auto& infpair : mapInfinitynodes) {
         auto it = mapLastPaid.find(infpair.second.getScriptPublicKey());
-        if (it != mapLastPaid.end()) {
-            infpair.second.setLastRewardHeight(mapLastPaid[infpair.second.getScriptPublicKey()]);
-        }
+        infpair.second.setLastRewardHeight(it != mapLastPaid.end() ? it->second : -1);
     }
 }
 
+/**
+* Extend the reward statements of nSinType up to the tip. A statement starts
+* where the previous one ends and pays each node burnt before its start and
+* not expired at it once.
+*/
 bool CInfinitynodeMan::deterministicRewardStatement(int nSinType)
 {
-    int stm_height_temp = Params().GetConsensus().nInfinityNodeGenesisStatement;
-    int stm_size_temp = 0;
-    if (nSinType == 10) mapStatementBIG.clear();
-    if (nSinType == 5) mapStatementMID.clear();
-    if (nSinType == 1) mapStatementLIL.clear();
-
     LOCK(cs);
+    if (mapInfinitynodes.empty()) return false;
+
+    std::map<int, int>& mapStatement = nSinType == 10 ? mapStatementBIG : nSinType == 5 ? mapStatementMID : mapStatementLIL;
+    // a statement counts the nodes burnt before it starts, so only the ones
+    // starting after a node that matured or was disconnected since are redone
+    auto itDirty = mapStatementDirtyHeight.find(nSinType);
+    if (itDirty != mapStatementDirtyHeight.end()) {
+        mapStatement.erase(mapStatement.upper_bound(itDirty->second), mapStatement.end());
+        mapStatementDirtyHeight.erase(itDirty);
+    }
+    int stm_height_temp = Params().GetConsensus().nInfinityNodeGenesisStatement;
+    if (!mapStatement.empty())
+        stm_height_temp = mapStatement.rbegin()->first + mapStatement.rbegin()->second;
+    const int nFromHeight = stm_height_temp;
+
+    // sweep over the heights the nodes start and expire at: a node is in
+    // the statements starting in (height, expire height]
+    const CInfinitynodeTypeIndex& type = getTypeIndex(nSinType);
+    const std::vector<int>& vStartHeight = type.vHeight;
+    std::vector<int> vExpireHeight(type.vExpireHeight);
+    std::sort(vExpireHeight.begin(), vExpireHeight.end());
+
+    auto itStart = vStartHeight.begin();
+    auto itExpire = vExpireHeight.begin();
+    int totalSinType = 0;
     while (stm_height_temp < nCachedBlockHeight)
     {
-        std::map<COutPoint, CInfinitynode> mapInfinitynodesCopy;
-        int totalSinType = 0;
-        for (auto& infpair : mapInfinitynodes) {
-            CInfinitynode inf = infpair.second;
-            if (inf.getSINType() == nSinType && inf.getHeight() < stm_height_temp && stm_height_temp <= inf.getExpireHeight()){
-                mapInfinitynodesCopy[inf.vinBurnFund.prevout] = inf;
-                ++totalSinType;
-            }
-        }
-        //update variable for each SinType
-        if (nSinType == 10)
-        {
-            mapStatementBIG[stm_height_temp] = totalSinType;
-            nBIGLastStmHeight = stm_height_temp;
-            nBIGLastStmSize = totalSinType;
-        }
-
-        if (nSinType == 5)
-        {
-            mapStatementMID[stm_height_temp] = totalSinType;
-            nMIDLastStmHeight = stm_height_temp;
-            nMIDLastStmSize = totalSinType;
+        for (; itStart != vStartHeight.end() && *itStart < stm_height_temp; ++itStart) ++totalSinType;
+        for (; itExpire != vExpireHeight.end() && *itExpire < stm_height_temp; ++itExpire) --totalSinType;
+        mapStatement[stm_height_temp] = totalSinType;
+        if (totalSinType == 0) {
+            //no node to pay: the next statement starts once the next node
+            //burnt can be paid, or is redone from here when one matures
+            if (itStart == vStartHeight.end()) break;
+            stm_height_temp = *itStart + 1;
+            continue;
         }
+        stm_height_temp = stm_height_temp + totalSinType;
+    }
 
-        if (nSinType == 1)
-        {
-            mapStatementLIL[stm_height_temp] = totalSinType;
-            nLILLastStmHeight = stm_height_temp;
-            nLILLastStmSize = totalSinType;
-        }
+    //update variable for each SinType
+    if (!mapStatement.empty()) {
+        if (nSinType == 10) std::tie(nBIGLastStmHeight, nBIGLastStmSize) = *mapStatement.rbegin();
+        if (nSinType == 5) std::tie(nMIDLastStmHeight, nMIDLastStmSize) = *mapStatement.rbegin();
+        if (nSinType == 1) std::tie(nLILLastStmHeight, nLILLastStmSize) = *mapStatement.rbegin();
+    }
+    mapStatementIndex.erase(nSinType);
 
-        //loop
-        stm_height_temp = stm_height_temp + totalSinType;
-        stm_size_temp = totalSinType;
+    if (g_infinitynodeindex) {
+        return g_infinitynodeindex->WriteStatements(nSinType, nFromHeight, mapStatement);
     }
     return true;
 }
@@ -415,35 +852,19 @@ std::string CInfinitynodeMan::getLastStatementString() const
 *
 * called in CheckAndRemove
 */
-std::map<int, CInfinitynode> CInfinitynodeMan::calculInfinityNodeRank(int nBlockHeight, int nSinType, bool updateList)
+void CInfinitynodeMan::calculInfinityNodeRank(int nBlockHeight, int nSinType)
 {
     AssertLockHeld(cs);
-    std::vector<std::pair<int, CInfinitynode*> > vecCInfinitynodeHeight;
-    std::map<int, CInfinitynode> retMapInfinityNodeRank;
-
-    for (auto& infpair : mapInfinitynodes) {
-        CInfinitynode inf = infpair.second;
-        //reinitial Rank to 0 all nodes of nSinType
-        if (inf.getSINType() == nSinType) infpair.second.setRank(0);
-        //put valid node in vector
-        if (inf.getSINType() == nSinType && inf.getExpireHeight() >= nBlockHeight && inf.getHeight() < nBlockHeight)
-        {
-            vecCInfinitynodeHeight.push_back(std::make_pair(inf.getHeight(), &infpair.second));
-        }
-    }
+    const CInfinitynodeTypeIndex& type = getTypeIndex(nSinType);
 
-    // Sort them low to high
-    sort(vecCInfinitynodeHeight.begin(), vecCInfinitynodeHeight.end(), CompareIntValue());
-    //update Rank at nBlockHeight
+    //update Rank at nBlockHeight, nodes are sorted low to high
     int rank=1;
-    for (std::pair<int, CInfinitynode*>& s : vecCInfinitynodeHeight){
-        auto it = mapInfinitynodes.find(s.second->vinBurnFund.prevout);
-        if(updateList) it->second.setRank(rank);
-        retMapInfinityNodeRank[rank] = *s.second;
-        ++rank;
+    for (size_t i = 0; i < type.vNode.size(); ++i) {
+        if (type.vHeight[i] < nBlockHeight && type.vExpireHeight[i] >= nBlockHeight)
+            type.vNode[i]->setRank(rank++);
+        else
+            type.vNode[i]->setRank(0);
     }
-
-    return retMapInfinityNodeRank;
 }
 
 /*
@@ -452,33 +873,89 @@ std::map<int, CInfinitynode> CInfinitynodeMan::calculInfinityNodeRank(int nBlock
 void CInfinitynodeMan::calculAllInfinityNodesRankAtLastStm()
 {
     LOCK(cs);
-        calculInfinityNodeRank(nBIGLastStmHeight, 10, true);
-        calculInfinityNodeRank(nMIDLastStmHeight, 5, true);
-        calculInfinityNodeRank(nLILLastStmHeight, 1, true);
+        calculInfinityNodeRank(nBIGLastStmHeight, 10);
+        calculInfinityNodeRank(nMIDLastStmHeight, 5);
+        calculInfinityNodeRank(nLILLastStmHeight, 1);
+        publishSnapshot();
 }
 
 bool CInfinitynodeMan::deterministicRewardAtHeight(int nBlockHeight, int nSinType, CInfinitynode& infinitynodeRet)
 {
     assert(nBlockHeight >= Params().GetConsensus().nInfinityNodeGenesisStatement);
-    //step1: copy mapStatement for nSinType
-    std::map<int, int> mapStatementSinType = getStatementMap(nSinType);
-
     LOCK(cs);
-    //step2: find last Statement for nBlockHeight;
-    int nDelta = 100000; //big enough > number of 
-    int lastStatement = 0;
-    for(auto& stm : mapStatementSinType)
-    {
-        if (nBlockHeight > stm.first && nDelta > (nBlockHeight -stm.first))
-        {
-            nDelta = nBlockHeight -stm.first;
-            if(nDelta <= stm.second) lastStatement = stm.first;
+    return getStatementIndex(nSinType).Find(nBlockHeight, infinitynodeRet);
+}
+
+const CInfinitynodeTypeIndex& CInfinitynodeMan::getTypeIndex(int nSinType)
+{
+    AssertLockHeld(cs);
+    auto it = mapTypeIndex.find(nSinType);
+    if (it != mapTypeIndex.end())
+        return it->second;
+
+    std::vector<std::pair<int, CInfinitynode*> > vecCInfinitynodeHeight;
+    for (auto& infpair : mapInfinitynodes) {
+        if (infpair.second.getSINType() == nSinType)
+            vecCInfinitynodeHeight.push_back(std::make_pair(infpair.second.getHeight(), &infpair.second));
+    }
+    // Sort them low to high
+    sort(vecCInfinitynodeHeight.begin(), vecCInfinitynodeHeight.end(), CompareIntValue());
+
+    CInfinitynodeTypeIndex& type = mapTypeIndex[nSinType];
+    type.vHeight.reserve(vecCInfinitynodeHeight.size());
+    type.vExpireHeight.reserve(vecCInfinitynodeHeight.size());
+    type.vNode.reserve(vecCInfinitynodeHeight.size());
+    for (const std::pair<int, CInfinitynode*>& s : vecCInfinitynodeHeight) {
+        type.vHeight.push_back(s.first);
+        type.vExpireHeight.push_back(s.second->getExpireHeight());
+        type.vNode.push_back(s.second);
+    }
+    return type;
+}
+
+/**
+* Rank the matured nodes of nSinType for each of its statements, the same
+* way as calculInfinityNodeRank()
+*/
+const CInfinitynodeStatementIndex& CInfinitynodeMan::getStatementIndex(int nSinType)
+{
+    AssertLockHeld(cs);
+    auto it = mapStatementIndex.find(nSinType);
+    if (it != mapStatementIndex.end())
+        return it->second;
+
+    CInfinitynodeStatementIndex& index = mapStatementIndex[nSinType];
+    const CInfinitynodeTypeIndex& type = getTypeIndex(nSinType);
+
+    const std::map<int, int>& mapStatement = nSinType == 10 ? mapStatementBIG : nSinType == 5 ? mapStatementMID : mapStatementLIL;
+    for (const auto& stm : mapStatement) {
+        index.vStartHeight.push_back(stm.first);
+        index.vSize.push_back(stm.second);
+        index.vRankedNodes.emplace_back();
+        // nodes are sorted by height, the ones after the statement start are not in it
+        for (size_t i = 0; i < type.vNode.size() && type.vHeight[i] < stm.first; ++i) {
+            if (type.vExpireHeight[i] >= stm.first)
+                index.vRankedNodes.back().push_back(type.vNode[i]);
         }
     }
-    //return false if not found statement
-    if (lastStatement == 0) return false;
+    return index;
+}
+
+bool CInfinitynodeStatementIndex::Find(int nBlockHeight, CInfinitynode& infinitynodeRet) const
+{
+    // last statement starting before nBlockHeight
+    auto it = std::lower_bound(vStartHeight.begin(), vStartHeight.end(), nBlockHeight);
+    if (it == vStartHeight.begin())
+        return false;
+    size_t i = it - vStartHeight.begin() - 1;
+    int nRank = nBlockHeight - vStartHeight[i];
+    if (nRank > vSize[i])
+        return false;
 
-    std::map<int, CInfinitynode> rankOfStatement = calculInfinityNodeRank(lastStatement, nSinType, false);
-    infinitynodeRet = rankOfStatement[nBlockHeight - lastStatement];
+    // the statement size is counted when it is made, nodes can be removed by a reorg since
+    if ((size_t)nRank <= vRankedNodes[i].size())
+        infinitynodeRet = *vRankedNodes[i][nRank - 1];
+    else
+        infinitynodeRet = CInfinitynode();
     return true;
 }
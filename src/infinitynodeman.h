@@ -6,7 +6,11 @@
 #define SIN_INFINITYNODEMAN_H
 
 #include <infinitynode.h>
+#include <script/saltedhasher.h>
+#include <validationinterface.h>
 
+#include <memory>
+#include <unordered_map>
 
 
 using namespace std;
@@ -16,8 +20,77 @@ class CConnman;
 
 extern CInfinitynodeMan infnodeman;
 
-class CInfinitynodeMan
+/** Run an instance of the infinitynode block scan thread */
+void ThreadInfinitynodeScan();
+
+/** Last paid height by payee script */
+typedef std::unordered_map<CScript, int, SaltedScriptHasher> CInfinitynodeLastPaidMap;
+
+/** What connecting one block changed in the infinitynode list */
+struct CInfinitynodeBlockUndo
+{
+    int nHeight;
+    //! Burn funds the block added
+    std::vector<COutPoint> vAddedNodes;
+    //! Payees the block paid, with their previous last paid height (-1 for none)
+    std::vector<std::pair<CScript, int>> vLastPaidBefore;
+};
+
+/** Burn funds and payees found in one block by a scan from disk */
+struct CInfinitynodeBlockScan
 {
+    std::vector<CInfinitynode> vNodes;
+    std::vector<CScript> vPayees;
+};
+
+/**
+* Matured infinitynodes of one SIN type in rank order (burn height, then burn
+* outpoint), as parallel arrays so ranking passes read only what they need
+*/
+struct CInfinitynodeTypeIndex
+{
+    std::vector<int> vHeight;
+    std::vector<int> vExpireHeight;
+    //! The nodes themselves, in mapInfinitynodes
+    std::vector<CInfinitynode*> vNode;
+};
+
+/**
+* Reward statements of one SIN type with the nodes they pay, so the node paid
+* at a height is found with a binary search
+*/
+struct CInfinitynodeStatementIndex
+{
+    //! Start heights of the statements, ascending
+    std::vector<int> vStartHeight;
+    //! Number of nodes each statement pays
+    std::vector<int> vSize;
+    //! vRankedNodes[i][nRank - 1] is paid at height vStartHeight[i] + nRank
+    std::vector<std::vector<CInfinitynode*>> vRankedNodes;
+
+    /// Find the node paid at nBlockHeight, false if no statement covers it
+    bool Find(int nBlockHeight, CInfinitynode& infinitynodeRet) const;
+};
+
+/**
+* Immutable copy of the infinitynode list, published after each update so
+* readers do not need the manager lock
+*/
+struct CInfinitynodeSnapshot
+{
+    std::map<COutPoint, CInfinitynode> mapInfinitynodes;
+    std::map<COutPoint, CInfinitynode> mapInfinitynodesNonMatured;
+    CInfinitynodeLastPaidMap mapLastPaid;
+    //! Last statement height and size by SIN type
+    std::map<int, std::pair<int, int>> mapLastStatement;
+    int64_t nLastScanHeight = 0;
+};
+
+class CInfinitynodeMan : public CValidationInterface
+{
+    friend struct CInfinitynodeManTest;
+    friend struct CInfinitynodeManBench;
+
 public:
 
 private:
@@ -30,6 +103,8 @@ private:
 
     //make sure that this value is sup than chain reorg limit. After this depth, situation of MAP is matured
     static const int INF_MATURED_LIMIT = 55;
+    //blocks per thread read from disk between two merges into the list of a scan
+    static const int INF_SCAN_CHUNK_SIZE = 500;
 
     // map to hold all INFs
     std::map<COutPoint, CInfinitynode> mapInfinitynodes;
@@ -45,10 +120,49 @@ private:
     int nBIGLastStmSize;
     int nMIDLastStmSize;
     int nLILLastStmSize;
+    // by SIN type, the lowest burn height of the nodes that matured or were
+    // removed since the statements were last extended
+    std::map<int, int> mapStatementDirtyHeight;
+
+    // matured nodes and statements with their ranked nodes by SIN type,
+    // built when first needed and cleared when the matured nodes or the
+    // statements change
+    std::map<int, CInfinitynodeTypeIndex> mapTypeIndex;
+    std::map<int, CInfinitynodeStatementIndex> mapStatementIndex;
 
     // map to hold payee and lastPaid Height
-    std::map<CScript, int> mapLastPaid;
+    CInfinitynodeLastPaidMap mapLastPaid;
     mutable CCriticalSection cs_LastPaid;
+    // matured nodes by payee script, built when first needed and cleared
+    // with the other node indexes
+    std::unordered_map<CScript, std::vector<CInfinitynode*>, SaltedScriptHasher> mapPayeeNodes;
+
+    // Last block the list includes, null while it has to be scanned from disk
+    const CBlockIndex* pindexListTip;
+    // undo data of the last INF_MATURED_LIMIT blocks of the list, by block hash
+    std::map<uint256, CInfinitynodeBlockUndo> mapBlockUndo;
+
+    static bool scanBlocks(const std::vector<const CBlockIndex*>& vScanIndex, size_t nBegin, size_t nEnd, std::vector<CInfinitynodeBlockScan>& vScanRet);
+    // the list as readers see it, replaced with std::atomic_store
+    std::shared_ptr<const CInfinitynodeSnapshot> snapshot;
+
+    // publish once per update of the list (a block, a build, new statements),
+    // not once per change: each call copies the whole list
+    void publishSnapshot();
+    // Clear() without publishing, for a list about to be rebuilt
+    void clear();
+    void connectTip(const CBlockIndex* pindex, const std::vector<CInfinitynode>& vNodes, const std::vector<CScript>& vPayees);
+    void addScannedBlocks(const std::vector<const CBlockIndex*>& vScanIndex, size_t nBegin, const std::vector<CInfinitynodeBlockScan>& vScan, const CBlockIndex* pindexTip);
+    void setListTip(const CBlockIndex* pindex);
+    void addBlockInfinitynodes(const CBlockIndex* pindex, const std::vector<CInfinitynode>& vNodes, const std::vector<CScript>& vPayees, bool fLastPaid, CInfinitynodeBlockUndo& undo);
+    bool disconnectTip();
+    void disconnectBlock(const CInfinitynodeBlockUndo& undo);
+    void updateMaturity(int nTipHeight);
+    void setStatementsDirty(int nSinType, int nHeight);
+    void clearNodeIndexes() { mapTypeIndex.clear(); mapStatementIndex.clear(); mapPayeeNodes.clear(); }
+    void setLastPaid(const CScript& payee, int nHeight);
+    const CInfinitynodeTypeIndex& getTypeIndex(int nSinType);
+    const CInfinitynodeStatementIndex& getStatementIndex(int nSinType);
 
 
 public:
@@ -72,7 +186,16 @@ public:
         }
 
         READWRITE(mapInfinitynodes);
-        READWRITE(mapLastPaid);
+        {
+            // stored ordered, as in earlier versions
+            LOCK(cs_LastPaid);
+            std::map<CScript, int> mapLastPaidOrdered(mapLastPaid.begin(), mapLastPaid.end());
+            READWRITE(mapLastPaidOrdered);
+            if(ser_action.ForRead()) {
+                mapLastPaid.clear();
+                mapLastPaid.insert(mapLastPaidOrdered.begin(), mapLastPaidOrdered.end());
+            }
+        }
         READWRITE(nLastScanHeight);
         READWRITE(mapStatementBIG);
         READWRITE(mapStatementMID);
@@ -84,13 +207,20 @@ public:
         READWRITE(nMIDLastStmSize);
         READWRITE(nLILLastStmSize);
 
+        if(ser_action.ForRead()) {
+            clearNodeIndexes();
+        }
         if(ser_action.ForRead() && (strVersion != SERIALIZATION_VERSION_STRING)) {
             Clear();
         }
+        if(ser_action.ForRead()) {
+            publishSnapshot();
+        }
     }
 
     std::string ToString() const;
 
+    /// Add a matured node, readers see it once the next snapshot is published
     bool Add(CInfinitynode &mn);
     bool AddUpdateLastPaid(CScript scriptPubKey, int nHeightLastPaid);
     /// Find an entry
@@ -102,8 +232,10 @@ public:
     bool Has(const COutPoint& outpoint);
     bool HasPayee(CScript scriptPubKey);
     int Count();
-    std::map<COutPoint, CInfinitynode> GetFullInfinitynodeMap() { LOCK(cs); return mapInfinitynodes; }
-    std::map<COutPoint, CInfinitynode> GetFullInfinitynodeNonMaturedMap() { LOCK(cs); return mapInfinitynodesNonMatured; }
+    /// The list as of the last update, can be read without any lock
+    std::shared_ptr<const CInfinitynodeSnapshot> GetSnapshot() const { return std::atomic_load(&snapshot); }
+    std::map<COutPoint, CInfinitynode> GetFullInfinitynodeMap() { return GetSnapshot()->mapInfinitynodes; }
+    std::map<COutPoint, CInfinitynode> GetFullInfinitynodeNonMaturedMap() { return GetSnapshot()->mapInfinitynodesNonMatured; }
     std::map<int, int> getStatementMap(int nSinType){
         LOCK(cs);
         if(nSinType == 10) return mapStatementBIG;
@@ -111,31 +243,37 @@ public:
         if(nSinType == 1) return mapStatementLIL;
     }
     int getLastStatement(int nSinType){
-        LOCK(cs);
-        if(nSinType == 10) return nBIGLastStmHeight;
-        if(nSinType == 5) return nMIDLastStmHeight;
-        if(nSinType == 1) return nLILLastStmHeight;
+        std::shared_ptr<const CInfinitynodeSnapshot> snap = GetSnapshot();
+        auto it = snap->mapLastStatement.find(nSinType);
+        return it == snap->mapLastStatement.end() ? 0 : it->second.first;
     }
     int getLastStatementSize(int nSinType){
-        LOCK(cs);
-        if(nSinType == 10) return nBIGLastStmSize;
-        if(nSinType == 5) return nMIDLastStmSize;
-        if(nSinType == 1) return nLILLastStmSize;
+        std::shared_ptr<const CInfinitynodeSnapshot> snap = GetSnapshot();
+        auto it = snap->mapLastStatement.find(nSinType);
+        return it == snap->mapLastStatement.end() ? 0 : it->second.second;
     }
 
-    std::map<CScript, int> GetFullLastPaidMap() { return mapLastPaid; }
-    int64_t getLastScan(){return nLastScanHeight;}
-    int64_t getLastScanWithLimit(){return nLastScanHeight + INF_MATURED_LIMIT;}
+    CInfinitynodeLastPaidMap GetFullLastPaidMap() { return GetSnapshot()->mapLastPaid; }
+    int64_t getLastScan(){return GetSnapshot()->nLastScanHeight;}
+    int64_t getLastScanWithLimit(){return GetSnapshot()->nLastScanHeight + INF_MATURED_LIMIT;}
 
+    /// Find the burn funds and the infinitynode payees of a block
+    static bool getBlockInfinitynodes(const CBlock& block, const CBlockIndex* pindex, std::vector<CInfinitynode>& vNodesRet, std::vector<CScript>& vPayeesRet);
     bool buildInfinitynodeList(int nBlockHeight, int nLowHeight = 165000);
     bool buildListForBlock(int nBlockHeight);
     void updateLastPaid();
     bool updateInfinitynodeList(int fromHeight);//call in init.cppp
     bool initialInfinitynodeList(int fromHeight);//call in init.cpp
+    /// Load the list from the infinitynode index, up to height nBlockHeight
+    bool loadFromIndex(int nBlockHeight);
+    /// Bring the list to the active chain tip, for the blocks connected or
+    /// disconnected before the manager was registered for them
+    void syncToChainTip();
 
+    /// Extend the statements of nSinType, the caller publishes the snapshot
     bool deterministicRewardStatement(int nSinType);
     bool deterministicRewardAtHeight(int nBlockHeight, int nSinType, CInfinitynode& infinitynodeRet);
-    std::map<int, CInfinitynode> calculInfinityNodeRank(int nBlockHeight, int nSinType, bool updateList=false);
+    void calculInfinityNodeRank(int nBlockHeight, int nSinType);
     void calculAllInfinityNodesRankAtLastStm();
     std::pair<int, int> getLastStatementBySinType(int nSinType);
     std::string getLastStatementString() const;
@@ -144,6 +282,12 @@ public:
     void CheckAndRemove(CConnman& connman);
     /// This is dummy overload to be used for dumping/loading mncache.dat
     void CheckAndRemove() {}
-    void UpdatedBlockTip(const CBlockIndex *pindex);
+    /// Called by CDSNotificationInterface when the tip changes
+    void UpdateChainTip(const CBlockIndex *pindex);
+
+protected:
+    // CValidationInterface: keep the list at the tip from the blocks in memory
+    void BlockConnected(const std::shared_ptr<const CBlock>& pblock, const CBlockIndex* pindex, const std::vector<CTransactionRef>& vtxConflicted) override;
+    void BlockDisconnected(const std::shared_ptr<const CBlock>& pblock) override;
 };
 #endif // SIN_INFINITYNODEMAN_H
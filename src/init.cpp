@@ -18,10 +18,12 @@
 #include <chainparams.h>
 #include <checkpoints.h>
 #include <compat/sanity.h>
+#include <crypto/x25x.h>
 #include <consensus/validation.h>
 #include <fs.h>
 #include <httpserver.h>
 #include <httprpc.h>
+#include <index/infinitynodeindex.h>
 #include <index/txindex.h>
 #include <key.h>
 #include <key_io.h>
@@ -36,6 +38,7 @@
 #include <rpc/server.h>
 #include <rpc/register.h>
 #include <rpc/blockchain.h>
+#include <rpc/mining.h>
 #include <script/standard.h>
 #include <script/sigcache.h>
 #include <scheduler.h>
@@ -209,6 +212,9 @@ void Interrupt()
     if (g_txindex) {
         g_txindex->Interrupt();
     }
+    if (g_infinitynodeindex) {
+        g_infinitynodeindex->Interrupt();
+    }
 }
 
 void Shutdown()
@@ -232,12 +238,14 @@ void Shutdown()
     StopHTTPServer();
     g_wallet_init_interface.Flush();
     StopMapPort();
+    if (g_connman) GenerateSINs(false, 0, Params(), *g_connman);
 
     // Because these depend on each-other, we make sure that neither can be
     // using the other before destroying them.
     if (peerLogic) UnregisterValidationInterface(peerLogic.get());
     if (g_connman) g_connman->Stop();
     if (g_txindex) g_txindex->Stop();
+    if (g_infinitynodeindex) g_infinitynodeindex->Stop();
 
     StopTorControl();
 
@@ -251,6 +259,7 @@ void Shutdown()
     peerLogic.reset();
     g_connman.reset();
     g_txindex.reset();
+    g_infinitynodeindex.reset();
 
     if (g_is_mempool_loaded && gArgs.GetArg("-persistmempool", DEFAULT_PERSIST_MEMPOOL)) {
         DumpMempool();
@@ -268,8 +277,10 @@ void Shutdown()
     flatdb4.Dump(netfulfilledman);
     //
     // Sinovate
-    CFlatDB<CInfinitynodeMan> flatdb5("infinitynode.dat", "magicInfinityNodeCache");
-    flatdb5.Dump(infnodeman);
+    if (!gArgs.GetBoolArg("-infinitynodeindex", DEFAULT_INFINITYNODEINDEX)) {
+        CFlatDB<CInfinitynodeMan> flatdb5("infinitynode.dat", "magicInfinityNodeCache");
+        flatdb5.Dump(infnodeman);
+    }
     //
 
     if (fFeeEstimatesInitialized)
@@ -434,6 +445,8 @@ void SetupServerArgs()
     gArgs.AddArg("-minimumchainwork=<hex>", strprintf("Minimum work assumed to exist on a valid chain in hex (default: %s, testnet: %s)", defaultChainParams->GetConsensus().nMinimumChainWork.GetHex(), testnetChainParams->GetConsensus().nMinimumChainWork.GetHex()), true, OptionsCategory::OPTIONS);
     gArgs.AddArg("-par=<n>", strprintf("Set the number of script verification threads (%u to %d, 0 = auto, <0 = leave that many cores free, default: %d)",
         -GetNumCores(), MAX_SCRIPTCHECK_THREADS, DEFAULT_SCRIPTCHECK_THREADS), false, OptionsCategory::OPTIONS);
+    gArgs.AddArg("-parheaders=<n>", strprintf("Set the number of header proof of work verification threads (%u to %d, 0 = auto, <0 = leave that many cores free, default: %d)",
+        -GetNumCores(), MAX_HEADERCHECK_THREADS, DEFAULT_HEADERCHECK_THREADS), false, OptionsCategory::OPTIONS);
     gArgs.AddArg("-persistmempool", strprintf("Whether to save the mempool on shutdown and load on restart (default: %u)", DEFAULT_PERSIST_MEMPOOL), false, OptionsCategory::OPTIONS);
 #ifndef WIN32
     gArgs.AddArg("-pid=<file>", strprintf("Specify pid file. Relative paths will be prefixed by a net-specific datadir location. (default: %s)", BITCOIN_PID_FILENAME), false, OptionsCategory::OPTIONS);
@@ -450,6 +463,7 @@ void SetupServerArgs()
 #else
     hidden_args.emplace_back("-sysperms");
 #endif
+    gArgs.AddArg("-infinitynodeindex", strprintf("Maintain an index of the on-chain infinitynode data, used to load the infinitynode list at startup (default: %u)", DEFAULT_INFINITYNODEINDEX), false, OptionsCategory::OPTIONS);
     gArgs.AddArg("-txindex", strprintf("Maintain a full transaction index, used by the getrawtransaction rpc call (default: %u)", DEFAULT_TXINDEX), false, OptionsCategory::OPTIONS);
 
     gArgs.AddArg("-addnode=<ip>", "Add a node to connect to and attempt to keep the connection open (see the `addnode` RPC command help for more info). This option can be specified multiple times to add multiple nodes.", false, OptionsCategory::CONNECTION);
@@ -511,6 +525,7 @@ void SetupServerArgs()
     gArgs.AddArg("-checkblocks=<n>", strprintf("How many blocks to check at startup (default: %u, 0 = all)", DEFAULT_CHECKBLOCKS), true, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-checklevel=<n>", strprintf("How thorough the block verification of -checkblocks is (0-4, default: %u)", DEFAULT_CHECKLEVEL), true, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-checkblockindex", strprintf("Do a full consistency check for mapBlockIndex, setBlockIndexCandidates, chainActive and mapBlocksUnlinked occasionally. (default: %u)", defaultChainParams->DefaultConsistencyChecks()), true, OptionsCategory::DEBUG_TEST);
+    gArgs.AddArg("-checkblockreads", strprintf("Recompute proof of work and block hash of every block read from disk, even if it was validated before being stored (default: %u)", DEFAULT_CHECK_BLOCK_READS), true, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-checkmempool=<n>", strprintf("Run checks every <n> transactions (default: %u)", defaultChainParams->DefaultConsistencyChecks()), true, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-checkpoints", strprintf("Disable expensive verification for known chain history (default: %u)", DEFAULT_CHECKPOINTS_ENABLED), true, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-deprecatedrpc=<method>", "Allows deprecated RPC method(s) to be used", true, OptionsCategory::DEBUG_TEST);
@@ -558,6 +573,7 @@ void SetupServerArgs()
     gArgs.AddArg("-blockmaxweight=<n>", strprintf("Set maximum BIP141 block weight (default: %d)", DEFAULT_BLOCK_MAX_WEIGHT), false, OptionsCategory::BLOCK_CREATION);
     gArgs.AddArg("-blockmintxfee=<amt>", strprintf("Set lowest fee rate (in %s/kB) for transactions to be included in block creation. (default: %s)", CURRENCY_UNIT, FormatMoney(DEFAULT_BLOCK_MIN_TX_FEE)), false, OptionsCategory::BLOCK_CREATION);
     gArgs.AddArg("-blockversion=<n>", "Override block version to test forking scenarios", true, OptionsCategory::BLOCK_CREATION);
+    gArgs.AddArg("-generatethreads=<n>", strprintf("Set the number of threads generate and generatetoaddress search nonces on (0 = auto, default: %d)", DEFAULT_GENERATE_THREADS), false, OptionsCategory::BLOCK_CREATION);
 
     gArgs.AddArg("-rest", strprintf("Accept public REST requests (default: %u)", DEFAULT_REST_ENABLE), false, OptionsCategory::RPC);
     gArgs.AddArg("-rpcallowip=<ip>", "Allow JSON-RPC connections from specified source. Valid for <ip> are a single IP (e.g. 1.2.3.4), a network/netmask (e.g. 1.2.3.4/255.255.255.0) or a network/CIDR (e.g. 1.2.3.4/24). This option can be specified multiple times", false, OptionsCategory::RPC);
@@ -859,6 +875,12 @@ void InitParameterInteraction()
             LogPrintf("%s: parameter interaction: -blocksonly=1 -> setting -whitelistrelay=0\n", __func__);
     }
 
+    // the infinitynode index reads the undo data of every block
+    if (gArgs.GetArg("-prune", 0)) {
+        if (gArgs.SoftSetBoolArg("-infinitynodeindex", false))
+            LogPrintf("%s: parameter interaction: -prune set -> setting -infinitynodeindex=0\n", __func__);
+    }
+
     // Forcing relay from whitelisted hosts implies we will accept relays from them in the first place.
     if (gArgs.GetBoolArg("-whitelistforcerelay", DEFAULT_WHITELISTFORCERELAY)) {
         if (gArgs.SoftSetBoolArg("-whitelistrelay", true))
@@ -998,6 +1020,9 @@ bool AppInitParameterInteraction()
             return InitError(_("Prune mode is incompatible with -txindex."));
     }
 
+    if (gArgs.GetArg("-prune", 0) && gArgs.GetBoolArg("-infinitynodeindex", DEFAULT_INFINITYNODEINDEX))
+        return InitError(_("Prune mode is incompatible with -infinitynodeindex."));
+
     // -bind and -whitebind can't be set when not listening
     size_t nUserBind = gArgs.GetArgs("-bind").size() + gArgs.GetArgs("-whitebind").size();
     if (nUserBind != 0 && !gArgs.GetBoolArg("-listen", DEFAULT_LISTEN)) {
@@ -1067,6 +1092,7 @@ bool AppInitParameterInteraction()
         mempool.setSanityCheck(1.0 / ratio);
     }
     fCheckBlockIndex = gArgs.GetBoolArg("-checkblockindex", chainparams.DefaultConsistencyChecks());
+    fCheckBlockReads = gArgs.GetBoolArg("-checkblockreads", DEFAULT_CHECK_BLOCK_READS);
     fCheckpointsEnabled = gArgs.GetBoolArg("-checkpoints", DEFAULT_CHECKPOINTS_ENABLED);
 
     hashAssumeValid = uint256S(gArgs.GetArg("-assumevalid", chainparams.GetConsensus().defaultAssumeValid.GetHex()));
@@ -1113,6 +1139,14 @@ bool AppInitParameterInteraction()
     else if (nScriptCheckThreads > MAX_SCRIPTCHECK_THREADS)
         nScriptCheckThreads = MAX_SCRIPTCHECK_THREADS;
 
+    nHeaderCheckThreads = gArgs.GetArg("-parheaders", DEFAULT_HEADERCHECK_THREADS);
+    if (nHeaderCheckThreads <= 0)
+        nHeaderCheckThreads += GetNumCores();
+    if (nHeaderCheckThreads <= 1)
+        nHeaderCheckThreads = 0;
+    else if (nHeaderCheckThreads > MAX_HEADERCHECK_THREADS)
+        nHeaderCheckThreads = MAX_HEADERCHECK_THREADS;
+
     // block pruning; get the amount of disk space (in MiB) to allot for block & undo files
     int64_t nPruneArg = gArgs.GetArg("-prune", 0);
     if (nPruneArg < 0) {
@@ -1258,6 +1292,8 @@ bool AppInitSanityChecks()
     // Initialize elliptic curve code
     std::string sha256_algo = SHA256AutoDetect();
     LogPrintf("Using the '%s' SHA256 implementation\n", sha256_algo);
+    std::string x25x_algo = X25XAutoDetect();
+    LogPrintf("Using the '%s' X25X implementation\n", x25x_algo);
     RandomInit();
     ECC_Start();
     globalVerifyHandle.reset(new ECCVerifyHandle());
@@ -1385,6 +1421,15 @@ bool AppInitMain()
     if (nScriptCheckThreads) {
         for (int i=0; i<nScriptCheckThreads-1; i++)
             threadGroup.create_thread(&ThreadScriptCheck);
+        // the infinitynode list is scanned from disk on as many threads
+        for (int i=0; i<nScriptCheckThreads-1; i++)
+            threadGroup.create_thread(&ThreadInfinitynodeScan);
+    }
+
+    LogPrintf("Using %u threads for header verification\n", nHeaderCheckThreads);
+    if (nHeaderCheckThreads) {
+        for (int i=0; i<nHeaderCheckThreads-1; i++)
+            threadGroup.create_thread(&ThreadHeaderCheck);
     }
 
     // Dash
@@ -1589,6 +1634,8 @@ bool AppInitMain()
     nTotalCache -= nBlockTreeDBCache;
     int64_t nTxIndexCache = std::min(nTotalCache / 8, gArgs.GetBoolArg("-txindex", DEFAULT_TXINDEX) ? nMaxTxIndexCache << 20 : 0);
     nTotalCache -= nTxIndexCache;
+    int64_t nInfinitynodeIndexCache = std::min(nTotalCache / 8, gArgs.GetBoolArg("-infinitynodeindex", DEFAULT_INFINITYNODEINDEX) ? nMaxInfinitynodeIndexCache << 20 : 0);
+    nTotalCache -= nInfinitynodeIndexCache;
     int64_t nCoinDBCache = std::min(nTotalCache / 2, (nTotalCache / 4) + (1 << 23)); // use 25%-50% of the remainder for disk cache
     nCoinDBCache = std::min(nCoinDBCache, nMaxCoinsDBCache << 20); // cap total coins db cache
     nTotalCache -= nCoinDBCache;
@@ -1599,6 +1646,9 @@ bool AppInitMain()
     if (gArgs.GetBoolArg("-txindex", DEFAULT_TXINDEX)) {
         LogPrintf("* Using %.1fMiB for transaction index database\n", nTxIndexCache * (1.0 / 1024 / 1024));
     }
+    if (gArgs.GetBoolArg("-infinitynodeindex", DEFAULT_INFINITYNODEINDEX)) {
+        LogPrintf("* Using %.1fMiB for infinitynode index database\n", nInfinitynodeIndexCache * (1.0 / 1024 / 1024));
+    }
     LogPrintf("* Using %.1fMiB for chain state database\n", nCoinDBCache * (1.0 / 1024 / 1024));
     LogPrintf("* Using %.1fMiB for in-memory UTXO set (plus up to %.1fMiB of unused mempool space)\n", nCoinCacheUsage * (1.0 / 1024 / 1024), nMempoolSizeMax * (1.0 / 1024 / 1024));
 
@@ -1784,6 +1834,10 @@ bool AppInitMain()
         g_txindex = MakeUnique<TxIndex>(nTxIndexCache, false, fReindex);
         g_txindex->Start();
     }
+    if (gArgs.GetBoolArg("-infinitynodeindex", DEFAULT_INFINITYNODEINDEX)) {
+        g_infinitynodeindex = MakeUnique<InfinitynodeIndex>(nInfinitynodeIndexCache, false, fReindex);
+        g_infinitynodeindex->Start();
+    }
 
     // ********************************************************* Step 9: load wallet
     if (!g_wallet_init_interface.Open()) return false;
@@ -1958,21 +2012,31 @@ bool AppInitMain()
 
     strDBName = "infinitynode.dat";
     uiInterface.InitMessage(_("Loading on-chain infinitynode list..."));
-    CFlatDB<CInfinitynodeMan> flatdb5(strDBName, "magicInfinityNodeCache");
-    if(!flatdb5.Load(infnodeman)) {
-        return InitError(_("Failed to load masternode cache from") + "\n" + (pathDB / strDBName).string());
-    }
-    if (infnodeman.getLastScan() == 0){
-        uiInterface.InitMessage(_("Initial on-chain infinitynode list..."));
-        if ( chainActive.Height() < Params().GetConsensus().nInfinityNodeBeginHeight || infnodeman.initialInfinitynodeList(chainActive.Height()) == false){
-            LogPrintf("InfinityNode does not begin or error in initial list of node:\n");
+    if (g_infinitynodeindex && g_infinitynodeindex->BlockUntilSyncedToCurrentChain()) {
+        if (chainActive.Height() < Params().GetConsensus().nInfinityNodeBeginHeight || !infnodeman.loadFromIndex(chainActive.Height())) {
+            LogPrintf("InfinityNode does not begin or error in loading list of node from index:\n");
         }
     } else {
-        uiInterface.InitMessage(_("Update on-chain infinitynode list..."));
-        if ( chainActive.Height() < infnodeman.getLastScan() || infnodeman.updateInfinitynodeList(chainActive.Height()) == false){
-            LogPrintf("Lastscan is higher than chainActive or error in update list of node:\n");
+        CFlatDB<CInfinitynodeMan> flatdb5(strDBName, "magicInfinityNodeCache");
+        if(!flatdb5.Load(infnodeman)) {
+            return InitError(_("Failed to load masternode cache from") + "\n" + (pathDB / strDBName).string());
+        }
+        if (infnodeman.getLastScan() == 0){
+            uiInterface.InitMessage(_("Initial on-chain infinitynode list..."));
+            if ( chainActive.Height() < Params().GetConsensus().nInfinityNodeBeginHeight || infnodeman.initialInfinitynodeList(chainActive.Height()) == false){
+                LogPrintf("InfinityNode does not begin or error in initial list of node:\n");
+            }
+        } else {
+            uiInterface.InitMessage(_("Update on-chain infinitynode list..."));
+            if ( chainActive.Height() < infnodeman.getLastScan() || infnodeman.updateInfinitynodeList(chainActive.Height()) == false){
+                LogPrintf("Lastscan is higher than chainActive or error in update list of node:\n");
+            }
         }
     }
+    // from here on the list follows the blocks as they are connected;
+    // ThreadImport may have connected some since the list was built
+    RegisterValidationInterface(&infnodeman);
+    infnodeman.syncToChainTip();
 
     // ********************************************************* Step 11b1: init and load data
 
@@ -93,7 +93,7 @@ bool CMasternode::UpdateFromNewBroadcast(CMasternodeBroadcast& mnb, CConnman& co
     return true;
 }
 
-void CMasternode::updateInfinityNodeInfo()
+bool CMasternode::updateInfinityNodeInfo()
 {
     AssertLockHeld(cs_main);
 
@@ -102,31 +102,31 @@ void CMasternode::updateInfinityNodeInfo()
 
     if(!GetUTXOCoin(vinBurnFund.prevout, coinBurnFund)) {
         LogPrintf("CMasternode::updateInfinityNodeInfo -- BurnFund tx not found %s-%d\n", vinBurnFund.prevout.hash.ToString(), vinBurnFund.prevout.n);
-        return;
+        return false;
     }
 
     if(!GetUTXOCoin(vin.prevout, coinCollateral)) {
         LogPrintf("CMasternode::updateInfinityNodeInfo -- BurnFund tx not found %s-%d\n", vin.prevout.hash.ToString(), vin.prevout.n);
-        return;
+        return false;
     }
 
     CTxDestination addressCollateral;
     if (!ExtractDestination(coinCollateral.out.scriptPubKey, addressCollateral)) {
         LogPrintf("CMasternode::updateInfinityNodeInfo -- Unknown destination of BurnFund tx\n");
-        return;
+        return false;
     }
 
     CTxDestination addressBurnNode;
     if (!ExtractDestination(coinBurnFund.out.scriptPubKey, addressBurnNode)) {
         LogPrintf("CMasternode::updateInfinityNodeInfo -- Unknown destination of addressBurnNode tx\n");
-        return;
+        return false;
     }
 
     CTransactionRef tx;
     uint256 hashblock;
     if(!GetTransaction(vinBurnFund.prevout.hash, tx, Params().GetConsensus(), hashblock, false)) {
         LogPrintf("CMasternode::updateInfinityNodeInfo -- BurnFund tx is not in block\n");
-        return;
+        return false;
     }
     const CTxIn& txin = tx->vin[0];
     int index = txin.prevout.n;
@@ -134,18 +134,18 @@ void CMasternode::updateInfinityNodeInfo()
     CTransactionRef prevtx;
     if(!GetTransaction(txin.prevout.hash, prevtx, Params().GetConsensus(), hashblock, false)) {
         LogPrintf("CMasternode::updateInfinityNodeInfo -- PrevBurnFund tx is not in block\n");
-        return;
+        return false;
     }
 
     std::vector<std::vector<unsigned char>> vSolutions;
     txnouttype whichType;
     const CScript& prevScript = coinBurnFund.out.scriptPubKey;
     Solver(prevScript, whichType, vSolutions);
-    if (whichType == TX_BURN_DATA){burnTxStandard="burn_and_data";}
+    burnTxStandard = whichType == TX_BURN_DATA ? "burn_and_data" : "nonstandard";
 
     CTxDestination addressBurnFund;
     if(!ExtractDestination(prevtx->vout[index].scriptPubKey, addressBurnFund)){
-        return;
+        return false;
     }
 
     nExpireHeight = coinBurnFund.nHeight + 720*365;
@@ -156,6 +156,8 @@ void CMasternode::updateInfinityNodeInfo()
     else { nSinType = nBurnAmount;}
     burnfundAddress = EncodeDestination(addressBurnFund);
     nodeBurntoAddress = EncodeDestination(addressBurnNode);
+    fInfinityNodeInfoCached = true;
+    return true;
 }
 
 
@@ -298,12 +300,16 @@ void CMasternode::Check(bool fForce)
 /*
     LogPrintf("CMasternode::Check -- BEFOR Burn[burnfundAddress: %s, Amount: %d, nodeBurnAddress: %s, ExpiredHeight:%d, SinType:%d, Standard:%s] / Collateral[ Address:%s, Amount: %d]\n", burnfundAddress, nBurnAmount, nodeBurntoAddress, nExpireHeight, GetSinTypeInt(), burnTxStandard, collateralAddress, nCollateralAmount);
 */
-    updateInfinityNodeInfo();
     int nHeight = 0;
     if(!fUnitTest) {
         TRY_LOCK(cs_main, lockMain);
         if(!lockMain) return;
 
+        // read once per broadcast, then again only when a block touches the outpoints
+        if(!fInfinityNodeInfoCached) {
+            updateInfinityNodeInfo();
+        }
+
         CollateralStatus err = CheckCollateral(vin.prevout);
         if (err == COLLATERAL_UTXO_NOT_FOUND) {
             nActiveState = MASTERNODE_OUTPOINT_SPENT;
@@ -484,46 +490,14 @@ std::string CMasternode::GetBurnFundTxInfo() const
     return strprintf("%s-%u",vinBurnFund.prevout.hash.ToString(), vinBurnFund.prevout.n);
 }
 
-void CMasternode::UpdateLastPaid(const CBlockIndex *pindex, int nMaxBlocksToScanBack)
+void CMasternode::UpdateLastPaid(const CBlockIndex *pindexLastPaid)
 {
-    if(!pindex) return;
-
-    const CBlockIndex *BlockReading = pindex;
-
-    CScript mnpayee = GetScriptForDestination(pubKeyCollateralAddress.GetID());
-    // LogPrint(BCLog::MASTERNODE, "CMasternode::UpdateLastPaidBlock -- searching for block with payment to %s\n", vin.prevout.ToStringShort());
-
-    LOCK(cs_mapMasternodeBlocks);
-
-    for (int i = 0; BlockReading && BlockReading->nHeight > nBlockLastPaid && i < nMaxBlocksToScanBack; i++) {
-        if(mnpayments.mapMasternodeBlocks.count(BlockReading->nHeight) &&
-            mnpayments.mapMasternodeBlocks[BlockReading->nHeight].HasPayeeWithVotes(mnpayee, 2))
-        {
-            CBlock block;
-            if(!ReadBlockFromDisk(block, BlockReading, Params().GetConsensus())) // shouldn't really happen
-                continue;
-
-	    CAmount nNodePaymentSINNODE_1 = GetMasternodePayment(BlockReading->nHeight, 1);
-	    CAmount nNodePaymentSINNODE_5 = GetMasternodePayment(BlockReading->nHeight, 5);
-	    CAmount nNodePaymentSINNODE_10 = GetMasternodePayment(BlockReading->nHeight, 10);
-
-            for (auto txout : block.vtx[0]->vout)
-                if(mnpayee == txout.scriptPubKey && (nNodePaymentSINNODE_1 == txout.nValue || 
-		   nNodePaymentSINNODE_5 == txout.nValue || nNodePaymentSINNODE_10 == txout.nValue)) {
-                   nBlockLastPaid = BlockReading->nHeight;
-                   nTimeLastPaid = BlockReading->nTime;
-                   LogPrint(BCLog::MASTERNODE, "CMasternode::UpdateLastPaidBlock -- searching for block with payment to %s -- found new %d\n", vin.prevout.ToStringShort(), nBlockLastPaid);
-                   return;
-                }
-        }
+    // a reorg can only leave an older payment in the index, keep the newer one as before
+    if(!pindexLastPaid || pindexLastPaid->nHeight <= nBlockLastPaid) return;
 
-        if (BlockReading->pprev == NULL) { assert(BlockReading); break; }
-        BlockReading = BlockReading->pprev;
-    }
-
-    // Last payment for this masternode wasn't found in latest mnpayments blocks
-    // or it was found in mnpayments blocks but wasn't found in the blockchain.
-    // LogPrint(BCLog::MASTERNODE, "CMasternode::UpdateLastPaidBlock -- searching for block with payment to %s -- keeping old %d\n", vin.prevout.ToStringShort(), nBlockLastPaid);
+    nBlockLastPaid = pindexLastPaid->nHeight;
+    nTimeLastPaid = pindexLastPaid->nTime;
+    LogPrint(BCLog::MASTERNODE, "CMasternode::UpdateLastPaidBlock -- found new %d for %s\n", nBlockLastPaid, vin.prevout.ToStringShort());
 }
 
 #ifdef ENABLE_WALLET
@@ -773,6 +747,9 @@ bool CMasternodeBroadcast::CheckOutpoint(int& nDos)
         }
         // remember the hash of the block where masternode collateral had minimum required confirmations
         nCollateralMinConfBlockHash = chainActive[nHeight + Params().GetConsensus().nMasternodeMinimumConfirmations - 1]->GetBlockHash();
+
+        // burn fund information goes with the masternode into the list
+        updateInfinityNodeInfo();
     }
 
     LogPrint(BCLog::MASTERNODE, "CMasternodeBroadcast::CheckOutpoint -- Masternode UTXO verified\n");
@@ -121,6 +121,7 @@ struct masternode_info_t
     std::string nodeBurntoAddress = "";
     std::string collateralAddress = "";
     std::string burnTxStandard = "nonstandard";
+    bool fInfinityNodeInfoCached = false; //* not in CMN, set once the fields above are read from the chain
 
     CTxIn vin{};
     CTxIn vinBurnFund{};
@@ -231,7 +232,9 @@ public:
 
     bool UpdateFromNewBroadcast(CMasternodeBroadcast& mnb, CConnman& connman);
     /*this function calcul all informations of infinityNode and update the variable which is init as "NULL" in masternode_info_t*/
-    void updateInfinityNodeInfo();
+    bool updateInfinityNodeInfo();
+    /// Read the infinityNode information again on the next Check, after a block touched its outpoints
+    void InvalidateInfinityNodeInfo() { fInfinityNodeInfoCached = false; nTimeLastChecked = 0; }
 
     CAmount CheckOutPointValue(const COutPoint& outpoint);
     
@@ -310,7 +313,7 @@ public:
 
     int GetLastPaidTime() { return nTimeLastPaid; }
     int GetLastPaidBlock() { return nBlockLastPaid; }
-    void UpdateLastPaid(const CBlockIndex *pindex, int nMaxBlocksToScanBack);
+    void UpdateLastPaid(const CBlockIndex *pindexLastPaid);
 
     // KEEP TRACK OF EACH GOVERNANCE ITEM INCASE THIS NODE GOES OFFLINE, SO WE CAN RECALC THEIR STATUS
     void AddGovernanceVote(uint256 nGovernanceObjectHash);
@@ -72,6 +72,7 @@ CMasternodeMan::CMasternodeMan()
   fMasternodesRemoved(false),
   vecDirtyGovernanceObjectHashes(),
   nLastWatchdogVoteTime(0),
+  rankCache(RANK_CACHE_SIZE),
   mapSeenMasternodeBroadcast(),
   mapSeenMasternodePing(),
   nDsqCount(0)
@@ -83,10 +84,120 @@ bool CMasternodeMan::Add(CMasternode &mn)
     if (Has(mn.vin.prevout)) return false;
     LogPrint(BCLog::MASTERNODE, "CMasternodeMan::Add -- Adding new Masternode: addr=%s, %i now\n", mn.addr.ToString(), size() + 1);
     mapMasternodes[mn.vin.prevout] = mn;
+    IndexMasternode(mn);
     fMasternodesAdded = true;
+    InvalidateRankCache();
+    if (setSharedBurnFunds.count(mn.vinBurnFund.prevout)) {
+        RemoveBurnFundNotUniqueNodes(mn.vinBurnFund.prevout);
+        return Has(mn.vin.prevout);
+    }
     return true;
 }
 
+void CMasternodeMan::IndexMasternode(const CMasternode& mn)
+{
+    AssertLockHeld(cs);
+    mapPayeeMasternodes[GetScriptForDestination(mn.pubKeyCollateralAddress.GetID())].insert(mn.vin.prevout);
+    std::set<COutPoint>& setBurnFund = mapBurnFundMasternodes[mn.vinBurnFund.prevout];
+    setBurnFund.insert(mn.vin.prevout);
+    if (setBurnFund.size() > 1) {
+        setSharedBurnFunds.insert(mn.vinBurnFund.prevout);
+    }
+    mapSinTypeMasternodes[mn.nSinType].insert(mn.vin.prevout);
+}
+
+void CMasternodeMan::UnindexMasternode(const CMasternode& mn)
+{
+    AssertLockHeld(cs);
+    auto it = mapPayeeMasternodes.find(GetScriptForDestination(mn.pubKeyCollateralAddress.GetID()));
+    if (it != mapPayeeMasternodes.end()) {
+        it->second.erase(mn.vin.prevout);
+        if (it->second.empty()) {
+            mapPayeeMasternodes.erase(it);
+        }
+    }
+    auto itBurnFund = mapBurnFundMasternodes.find(mn.vinBurnFund.prevout);
+    if (itBurnFund != mapBurnFundMasternodes.end()) {
+        itBurnFund->second.erase(mn.vin.prevout);
+        if (itBurnFund->second.size() <= 1) {
+            setSharedBurnFunds.erase(itBurnFund->first);
+        }
+        if (itBurnFund->second.empty()) {
+            mapBurnFundMasternodes.erase(itBurnFund);
+        }
+    }
+    // the type it was indexed with can be older than its current one
+    for (auto& typepair : mapSinTypeMasternodes) {
+        typepair.second.erase(mn.vin.prevout);
+    }
+}
+
+void CMasternodeMan::RebuildIndexes()
+{
+    AssertLockHeld(cs);
+    mapPayeeMasternodes.clear();
+    mapBurnFundMasternodes.clear();
+    setSharedBurnFunds.clear();
+    mapSinTypeMasternodes.clear();
+    for (const auto& mnpair : mapMasternodes) {
+        IndexMasternode(mnpair.second);
+    }
+    InvalidateRankCache();
+}
+
+std::map<COutPoint, CMasternode>::iterator CMasternodeMan::EraseMasternode(std::map<COutPoint, CMasternode>::iterator it)
+{
+    AssertLockHeld(cs);
+    UnindexMasternode(it->second);
+    InvalidateRankCache();
+    return mapMasternodes.erase(it);
+}
+
+void CMasternodeMan::UpdateSinTypeIndex(const CMasternode& mn)
+{
+    AssertLockHeld(cs);
+    // masternodes loaded from mncache.dat only get their SIN type once Check read their burn fund
+    if (mapSinTypeMasternodes[mn.nSinType].count(mn.vin.prevout)) return;
+    for (auto& typepair : mapSinTypeMasternodes) {
+        typepair.second.erase(mn.vin.prevout);
+    }
+    mapSinTypeMasternodes[mn.nSinType].insert(mn.vin.prevout);
+}
+
+std::map<COutPoint, CMasternode>::iterator CMasternodeMan::RemoveMasternode(std::map<COutPoint, CMasternode>::iterator it)
+{
+    AssertLockHeld(cs);
+
+    // erase all of the broadcasts we've seen from this txin, ...
+    mapSeenMasternodeBroadcast.erase(CMasternodeBroadcast(it->second).GetHash());
+    mWeAskedForMasternodeListEntry.erase(it->first);
+    // and finally remove it from the list
+    it->second.FlagGovernanceItemsAsDirty();
+    fMasternodesRemoved = true;
+    return EraseMasternode(it);
+}
+
+void CMasternodeMan::RemoveBurnFundNotUniqueNodes(const COutPoint& burnfund)
+{
+    AssertLockHeld(cs);
+    // the one with the oldest sigTime stays, the others are removed and banned
+    std::set<COutPoint> setBurnFund = mapBurnFundMasternodes.at(burnfund);
+    const CMasternode* pcandidate = nullptr;
+    for (const auto& outpoint : setBurnFund) {
+        const CMasternode& mn = mapMasternodes.at(outpoint);
+        if (!pcandidate || mn.sigTime < pcandidate->sigTime) pcandidate = &mn;
+    }
+    const COutPoint candidate = pcandidate->vin.prevout;
+    for (const auto& outpoint : setBurnFund) {
+        if (outpoint == candidate) continue;
+        auto it = mapMasternodes.find(outpoint);
+        LogPrintf("CMasternodeMan::RemoveBurnFundNotUniqueNodes -- masternode %s has newer sigTime than %s for burntx %s; removing from list\n",
+                    outpoint.ToStringShort(), candidate.ToStringShort(), burnfund.ToStringShort());
+        vecBurnFundAddrToBan.push_back(it->second.addr);
+        RemoveMasternode(it);
+    }
+}
+
 void CMasternodeMan::AskForMN(CNode* pnode, const COutPoint& outpoint, CConnman& connman)
 {
     if(!pnode) return;
@@ -162,148 +273,112 @@ void CMasternodeMan::Check()
 
     std::map<COutPoint, CMasternode>::iterator it = mapMasternodes.begin();
     while (it != mapMasternodes.end()) {
-        it->second.updateInfinityNodeInfo();
         it->second.Check();
+        UpdateSinTypeIndex(it->second);
         ++it;
     }
 }
 
-int CMasternodeMan::IsPayeeAValidMasternode(CScript payee)
+void CMasternodeMan::InvalidateInfinityNodeInfo(const CBlock& block)
 {
-    if(!masternodeSync.IsMasternodeListSynced()) return 1;
+    // the block is the only thing that can change burn fund information,
+    // either by spending the outpoints or by (re)creating them
+    std::set<uint256> setTxHash;
+    std::set<COutPoint> setSpent;
+    for (const auto& tx : block.vtx) {
+        setTxHash.insert(tx->GetHash());
+        for (const auto& txin : tx->vin) {
+            setSpent.insert(txin.prevout);
+        }
+    }
 
-    LOCK2(cs_main, cs);
+    LOCK(cs);
     for (auto& mnpair : mapMasternodes) {
-        CMasternodeBroadcast mnb = CMasternodeBroadcast(mnpair.second);
-        CScript currentMasternode = GetScriptForDestination(mnb.pubKeyCollateralAddress.GetID());
-        if(payee == currentMasternode)
-           return 2;
+        CMasternode& mn = mnpair.second;
+        if (setSpent.count(mn.vin.prevout) || setSpent.count(mn.vinBurnFund.prevout) ||
+            setTxHash.count(mn.vin.prevout.hash) || setTxHash.count(mn.vinBurnFund.prevout.hash)) {
+            LogPrint(BCLog::MASTERNODE, "CMasternodeMan::InvalidateInfinityNodeInfo -- block %s touches masternode=%s\n", block.GetHash().ToString(), mn.vin.prevout.ToStringShort());
+            mn.InvalidateInfinityNodeInfo();
+        }
     }
-    return 0;
+}
+
+int CMasternodeMan::IsPayeeAValidMasternode(CScript payee)
+{
+    if(!masternodeSync.IsMasternodeListSynced()) return 1;
+
+    LOCK(cs);
+    return mapPayeeMasternodes.count(payee) ? 2 : 0;
 }
 
 void CMasternodeMan::CheckAndRemoveBurnFundNotUniqueNode(CConnman& connman)
 {
     if(!masternodeSync.IsMasternodeListSynced()) return;
 
+    std::vector<CService> vecAddrToBan; //list node will be banned
     {
-            // we test two scenarios here, first is checking if winner is
-            // unique (has one entry with burntx) in the masternode list.
-            // (we populate nBurnFundMap first time checking this)
-            LOCK2(cs_main, cs);
-
-            std::map<COutPoint, CMasternode> nBurnFundMap;
-            std::vector<CMasternode> vpMasternodesToBan; //list node will be banned
-            for (auto& mnpair : mapMasternodes) {
-                    CMasternode mnb = mnpair.second;
-                    LogPrint(BCLog::MASTERNODE, "CMasternodeMan::CheckAndRemoveBurnFundNotUniqueNode -- burntx %s size %d find %d\n", 
-                                mnb.vinBurnFund.prevout.ToString(), nBurnFundMap.size(), nBurnFundMap.count(mnb.vinBurnFund.prevout));
-                    if (nBurnFundMap.count(mnb.vinBurnFund.prevout) > 0) {
-                        // conflict situation with someone else, choose older sigtime
-                            LogPrint(BCLog::MASTERNODE, "CMasternodeMan::CheckAndRemoveBurnFundNotUniqueNode -- burntx detected %s\n", mnb.vinBurnFund.prevout.ToStringShort());
-                            CMasternode candidate = nBurnFundMap.find(mnb.vinBurnFund.prevout)->second;
-
-                            // someone will be remove from FullMapMasternode and ban the connection
-                            if (candidate.sigTime > mnb.sigTime) {
-                                LogPrintf("CMasternodeMan::CheckAndRemoveBurnFundNotUniqueNode -- candidate %s has newer sigTime; removing from list\n",
-                                                candidate.vin.prevout.ToStringShort());
-                                vpMasternodesToBan.push_back(candidate);
-                                nBurnFundMap.erase(candidate.vinBurnFund.prevout);
-                                nBurnFundMap.insert(std::pair<COutPoint, CMasternode>(mnb.vinBurnFund.prevout, mnb));//add new masternode add valid member
-                            } else {
-                                LogPrintf("CMasternodeMan::CheckAndRemoveBurnFundNotUniqueNode -- new masternode %s has newer sigTime; removing from list\n",
-                                                mnb.vin.prevout.ToStringShort());
-                                vpMasternodesToBan.push_back(mnb);
-                            }
-                    } else {
-                        //new masternode with unique burntx. So add him
-                        nBurnFundMap.insert(std::pair<COutPoint, CMasternode>(mnb.vinBurnFund.prevout, mnb));
-                    }
-                    //add node in vector and check nLimitNode to ban
-            }
-            //Ban node
-            LogPrint(BCLog::MASTERNODE, "CMasternodeMan::CheckAndRemoveBurnFundNotUniqueNode -- ban vector %d\n",(int)vpMasternodesToBan.size());
-            if ((int)vpMasternodesToBan.size() > 0) {
-                LogPrint(BCLog::MASTERNODE, "CMasternodeMan::CheckAndRemoveBurnFundNotUniqueNode -- removing...\n");
-                std::vector<CNode*> vNodesCopy = connman.CopyNodeVector();
-                for (auto pmn : vpMasternodesToBan) {
-                    std::map<COutPoint, CMasternode>::iterator it;
-                    it = mapMasternodes.find(pmn.vin.prevout);
-
-                    CMasternodeBroadcast mnb = CMasternodeBroadcast(it->second);
-                    uint256 hash = mnb.GetHash();
-                    // erase all of the broadcasts we've seen from this txin, ...
-                    mapSeenMasternodeBroadcast.erase(hash);
-                    mWeAskedForMasternodeListEntry.erase(pmn.vin.prevout);
-                    // and finally remove it from the list
-                    it->second.FlagGovernanceItemsAsDirty();
-                    mapMasternodes.erase(it);
-
-                    LogPrint(BCLog::MASTERNODE, "CMasternodeMan::CheckAndRemoveBurnFundNotUniqueNode -- banning...%s\n", pmn.addr.ToString());
-                    CAddress add = CAddress(pmn.addr, NODE_NETWORK);
-                    for (auto* pnode : vNodesCopy) {
-                        if (pnode->addr == add) {
-                                //Misbehaving(pnode->GetId(), 100, "invalid sinnode");
-                                int64_t banTime = 86400 * 7; //7 days
-                                bool absolute = false;
-                                connman.Ban(pnode->addr, BanReasonManuallyAdded, banTime, absolute);
-                                LogPrint(BCLog::MASTERNODE, "CMasternodeMan::CheckAndRemoveBurnFundNotUniqueNode -- banned\n");
-                        }
-                    }
-                }
-                // looped through all nodes, release them
-                connman.ReleaseNodeVector(vNodesCopy);
-                NotifyMasternodeUpdates(connman);
+        LOCK(cs);
+        // a list loaded from mncache.dat can still hold shared burn funds
+        std::set<COutPoint> setBurnFunds = setSharedBurnFunds;
+        for (const auto& burnfund : setBurnFunds) {
+            RemoveBurnFundNotUniqueNodes(burnfund);
+        }
+        vecAddrToBan.swap(vecBurnFundAddrToBan);
+    }
+
+    //Ban node
+    LogPrint(BCLog::MASTERNODE, "CMasternodeMan::CheckAndRemoveBurnFundNotUniqueNode -- ban vector %d\n", (int)vecAddrToBan.size());
+    if (vecAddrToBan.empty()) return;
+
+    std::vector<CNode*> vNodesCopy = connman.CopyNodeVector();
+    for (const auto& addr : vecAddrToBan) {
+        LogPrint(BCLog::MASTERNODE, "CMasternodeMan::CheckAndRemoveBurnFundNotUniqueNode -- banning...%s\n", addr.ToString());
+        CAddress add = CAddress(addr, NODE_NETWORK);
+        for (auto* pnode : vNodesCopy) {
+            if (pnode->addr == add) {
+                int64_t banTime = 86400 * 7; //7 days
+                bool absolute = false;
+                connman.Ban(pnode->addr, BanReasonManuallyAdded, banTime, absolute);
+                LogPrint(BCLog::MASTERNODE, "CMasternodeMan::CheckAndRemoveBurnFundNotUniqueNode -- banned\n");
             }
+        }
     }
+    // looped through all nodes, release them
+    connman.ReleaseNodeVector(vNodesCopy);
+    NotifyMasternodeUpdates(connman);
 }
 
 void CMasternodeMan::CheckAndRemoveLimitNumberNode(CConnman& connman, int nSinType, int nLimit)
 {
     if(!masternodeSync.IsMasternodeListSynced()) return;
 
-    std::vector<std::pair<int64_t, CMasternode*> > vecSigTimeType;
-    std::vector<CMasternode> vpMasternodesToBan; //list node will be banned
-
-    for (auto& mnpair : mapMasternodes) {
-        if (mnpair.second.GetSinTypeInt() == nSinType) {
-            vecSigTimeType.push_back(std::make_pair(mnpair.second.sigTime, &mnpair.second));
-        }
-    }
-
-    // Sort them low to high
-    sort(vecSigTimeType.begin(), vecSigTimeType.end(), CompareSigTime());
+    {
+        LOCK(cs);
 
-    if (vecSigTimeType.size() <= nLimit) return;
+        auto itType = mapSinTypeMasternodes.find(nSinType);
+        if (itType == mapSinTypeMasternodes.end() || (int)itType->second.size() <= nLimit) return;
 
-	int count=0;
-    for (std::pair<int64_t, CMasternode*>& p : vecSigTimeType){
-        count++;
-        if (count >= nLimit) {
-            CMasternode mn = *p.second;
-            vpMasternodesToBan.push_back(mn);
+        std::vector<std::pair<int64_t, CMasternode*> > vecSigTimeType;
+        for (const auto& outpoint : itType->second) {
+            CMasternode& mn = mapMasternodes.at(outpoint);
+            vecSigTimeType.push_back(std::make_pair(mn.sigTime, &mn));
         }
-    }
 
-    if ((int)vpMasternodesToBan.size() > 0) {
-        LogPrint(BCLog::MASTERNODE, "CMasternodeMan::CheckAndRemoveBurnFundNotUniqueNode -- removing...\n");
-        std::vector<CNode*> vNodesCopy = connman.CopyNodeVector();
-        for (auto pmn : vpMasternodesToBan) {
-            std::map<COutPoint, CMasternode>::iterator it;
-            it = mapMasternodes.find(pmn.vin.prevout);
+        // Sort them low to high
+        sort(vecSigTimeType.begin(), vecSigTimeType.end(), CompareSigTime());
 
-            CMasternodeBroadcast mnb = CMasternodeBroadcast(it->second);
-            uint256 hash = mnb.GetHash();
-            // erase all of the broadcasts we've seen from this txin, ...
-            mapSeenMasternodeBroadcast.erase(hash);
-            mWeAskedForMasternodeListEntry.erase(pmn.vin.prevout);
-            // and finally remove it from the list
-            it->second.FlagGovernanceItemsAsDirty();
-            mapMasternodes.erase(it);
+        // only nLimit - 1 masternodes are kept once there are too many of them
+        std::vector<COutPoint> vecToRemove;
+        for (size_t i = std::max(nLimit, 1) - 1; i < vecSigTimeType.size(); ++i) {
+            vecToRemove.push_back(vecSigTimeType[i].second->vin.prevout);
+        }
+        LogPrint(BCLog::MASTERNODE, "CMasternodeMan::CheckAndRemoveLimitNumberNode -- removing %d masternodes of SIN type %d\n", (int)vecToRemove.size(), nSinType);
+        for (const auto& outpoint : vecToRemove) {
+            RemoveMasternode(mapMasternodes.find(outpoint));
         }
-
-        NotifyMasternodeUpdates(connman);
     }
+
+    NotifyMasternodeUpdates(connman);
 }
 
 
@@ -338,7 +413,7 @@ void CMasternodeMan::CheckAndRemove(CConnman& connman)
 
                 // and finally remove it from the list
                 it->second.FlagGovernanceItemsAsDirty();
-                mapMasternodes.erase(it++);
+                it = EraseMasternode(it);
                 fMasternodesRemoved = true;
             } else {
                 bool fAsk = (nAskForMnbRecovery > 0) &&
@@ -494,11 +569,13 @@ void CMasternodeMan::Clear()
 {
     LOCK(cs);
     mapMasternodes.clear();
+    RebuildIndexes();
     mAskedUsForMasternodeList.clear();
     mWeAskedForMasternodeList.clear();
     mWeAskedForMasternodeListEntry.clear();
     mapSeenMasternodeBroadcast.clear();
     mapSeenMasternodePing.clear();
+    vecBurnFundAddrToBan.clear();
     nDsqCount = 0;
     nLastWatchdogVoteTime = 0;
 }
@@ -534,14 +611,8 @@ int CMasternodeMan::CountEnabled(int nProtocolVersion)
 int CMasternodeMan::CountSinType(int nSinType)
 {
     LOCK(cs);
-    int nCount = 0;
-
-    for (auto& mnpair : mapMasternodes) {
-        if(mnpair.second.GetSinTypeInt() != nSinType) continue;
-        nCount++;
-    }
-
-    return nCount;
+    auto it = mapSinTypeMasternodes.find(nSinType);
+    return it == mapSinTypeMasternodes.end() ? 0 : it->second.size();
 }
 
 /* Only IPv4 masternodes are allowed in 12.1, saving this for later
@@ -628,14 +699,12 @@ bool CMasternodeMan::GetMasternodeInfo(const CPubKey& pubKeyMasternode, masterno
 bool CMasternodeMan::GetMasternodeInfo(const CScript& payee, masternode_info_t& mnInfoRet)
 {
     LOCK(cs);
-    for (auto& mnpair : mapMasternodes) {
-        CScript scriptCollateralAddress = GetScriptForDestination(mnpair.second.pubKeyCollateralAddress.GetID());
-        if (scriptCollateralAddress == payee) {
-            mnInfoRet = mnpair.second.GetInfo();
-            return true;
-        }
+    auto it = mapPayeeMasternodes.find(payee);
+    if (it == mapPayeeMasternodes.end()) {
+        return false;
     }
-    return false;
+    mnInfoRet = mapMasternodes.at(*it->second.begin()).GetInfo();
+    return true;
 }
 
 bool CMasternodeMan::Has(const COutPoint& outpoint)
@@ -826,6 +895,31 @@ bool CMasternodeMan::GetMasternodeScores(const uint256& nBlockHash, CMasternodeM
     return !vecMasternodeScoresRet.empty();
 }
 
+bool CMasternodeMan::GetCachedMasternodeRanks(const uint256& nBlockHash, int nMinProtocol, rank_cache_item_ptr& ranksRet)
+{
+    AssertLockHeld(cs);
+
+    const std::pair<uint256, int> key(nBlockHash, nMinProtocol);
+    if (rankCache.GetAndTouch(key, ranksRet))
+        return true;
+
+    // a failed or empty scoring (list not synced yet, no masternode of
+    // nMinProtocol) is not cached, it is retried on the next call
+    score_pair_vec_t vecMasternodeScores;
+    if (!GetMasternodeScores(nBlockHash, vecMasternodeScores, nMinProtocol))
+        return false;
+
+    std::shared_ptr<rank_cache_item_t> ranks = std::make_shared<rank_cache_item_t>();
+    ranks->vecOutpoints.reserve(vecMasternodeScores.size());
+    for (auto& scorePair : vecMasternodeScores) {
+        ranks->vecOutpoints.push_back(scorePair.second->vin.prevout);
+        ranks->mapRank.emplace(scorePair.second->vin.prevout, ranks->vecOutpoints.size());
+    }
+    ranksRet = ranks;
+    rankCache.Insert(key, ranksRet);
+    return true;
+}
+
 bool CMasternodeMan::GetMasternodeRank(const COutPoint& outpoint, int& nRankRet, int nBlockHeight, int nMinProtocol)
 {
     nRankRet = -1;
@@ -842,20 +936,16 @@ bool CMasternodeMan::GetMasternodeRank(const COutPoint& outpoint, int& nRankRet,
 
     LOCK(cs);
 
-    score_pair_vec_t vecMasternodeScores;
-    if (!GetMasternodeScores(nBlockHash, vecMasternodeScores, nMinProtocol))
+    rank_cache_item_ptr ranks;
+    if (!GetCachedMasternodeRanks(nBlockHash, nMinProtocol, ranks))
         return false;
 
-    int nRank = 0;
-    for (auto& scorePair : vecMasternodeScores) {
-        nRank++;
-        if(scorePair.second->vin.prevout == outpoint) {
-            nRankRet = nRank;
-            return true;
-        }
-    }
+    auto it = ranks->mapRank.find(outpoint);
+    if (it == ranks->mapRank.end())
+        return false;
 
-    return false;
+    nRankRet = it->second;
+    return true;
 }
 
 bool CMasternodeMan::GetMasternodeRanks(CMasternodeMan::rank_pair_vec_t& vecMasternodeRanksRet, int nBlockHeight, int nMinProtocol)
@@ -874,14 +964,14 @@ bool CMasternodeMan::GetMasternodeRanks(CMasternodeMan::rank_pair_vec_t& vecMast
 
     LOCK(cs);
 
-    score_pair_vec_t vecMasternodeScores;
-    if (!GetMasternodeScores(nBlockHash, vecMasternodeScores, nMinProtocol))
+    rank_cache_item_ptr ranks;
+    if (!GetCachedMasternodeRanks(nBlockHash, nMinProtocol, ranks))
         return false;
 
     int nRank = 0;
-    for (auto& scorePair : vecMasternodeScores) {
+    for (const auto& outpoint : ranks->vecOutpoints) {
         nRank++;
-        vecMasternodeRanksRet.push_back(std::make_pair(nRank, *scorePair.second));
+        vecMasternodeRanksRet.push_back(std::make_pair(nRank, mapMasternodes.at(outpoint)));
     }
 
     return true;
@@ -1541,6 +1631,8 @@ void CMasternodeMan::UpdateMasternodeList(CMasternodeBroadcast mnb, CConnman& co
             masternodeSync.BumpAssetLastTime("CMasternodeMan::UpdateMasternodeList - seen");
             mapSeenMasternodeBroadcast.erase(mnbOld.GetHash());
         }
+        // the broadcast can change the protocol version ranks are filtered by
+        InvalidateRankCache();
     }
 }
 
@@ -1599,7 +1691,10 @@ bool CMasternodeMan::CheckMnbAndUpdateMasternodeList(CNode* pfrom, CMasternodeBr
         CMasternode* pmn = Find(mnb.vin.prevout);
         if(pmn) {
             CMasternodeBroadcast mnbOld = mapSeenMasternodeBroadcast[CMasternodeBroadcast(*pmn).GetHash()].second;
-            if(!mnb.Update(pmn, nDos, connman)) {
+            bool fUpdated = mnb.Update(pmn, nDos, connman);
+            // the broadcast can change the protocol version ranks are filtered by
+            InvalidateRankCache();
+            if(!fUpdated) {
                 LogPrint(BCLog::MASTERNODE, "CMasternodeMan::CheckMnbAndUpdateMasternodeList -- Update() failed, masternode=%s\n", mnb.vin.prevout.ToStringShort());
                 return false;
             }
@@ -1611,7 +1706,13 @@ bool CMasternodeMan::CheckMnbAndUpdateMasternodeList(CNode* pfrom, CMasternodeBr
     }
 
     if(mnb.CheckOutpoint(nDos)) {
-        Add(mnb);
+        if(!Add(mnb)) {
+            // its burn fund is held by a masternode with an older sigTime,
+            // a broadcast that is not in the list is neither used nor relayed
+            LogPrint(BCLog::MASTERNODE, "CMasternodeMan::CheckMnbAndUpdateMasternodeList -- Add() failed, masternode=%s\n", mnb.vin.prevout.ToStringShort());
+            nDos = 0;
+            return false;
+        }
         masternodeSync.BumpAssetLastTime("CMasternodeMan::CheckMnbAndUpdateMasternodeList - new");
         // if it matches our Masternode privkey...
         if(fMasterNode && mnb.pubKeyMasternode == activeMasternode.pubKeyMasternode) {
@@ -1637,22 +1738,130 @@ bool CMasternodeMan::CheckMnbAndUpdateMasternodeList(CNode* pfrom, CMasternodeBr
     return true;
 }
 
+void CMasternodeMan::AddBlockPayees(const CBlock& block, const CBlockIndex* pindex)
+{
+    AssertLockHeld(cs);
+
+    if(block.vtx.empty()) return;
+
+    // the payments of each SIN type at this height, for every coinbase output
+    const CAmount nPaymentSINNODE_1 = GetMasternodePayment(pindex->nHeight, 1);
+    const CAmount nPaymentSINNODE_5 = GetMasternodePayment(pindex->nHeight, 5);
+    const CAmount nPaymentSINNODE_10 = GetMasternodePayment(pindex->nHeight, 10);
+
+    for (const auto& txout : block.vtx[0]->vout) {
+        if(txout.nValue == 0) continue;
+        if(txout.nValue != nPaymentSINNODE_1 && txout.nValue != nPaymentSINNODE_5 && txout.nValue != nPaymentSINNODE_10) continue;
+
+        // kept in height order, the first run scan adds blocks newest first
+        std::vector<const CBlockIndex*>& vecPaidBlocks = mapPayeePaidBlocks[txout.scriptPubKey];
+        auto it = std::lower_bound(vecPaidBlocks.begin(), vecPaidBlocks.end(), pindex,
+            [](const CBlockIndex* a, const CBlockIndex* b) { return a->nHeight < b->nHeight; });
+        if(it == vecPaidBlocks.end() || *it != pindex) {
+            vecPaidBlocks.insert(it, pindex);
+        }
+    }
+}
+
+void CMasternodeMan::PruneBlockPayees(int nHeight)
+{
+    AssertLockHeld(cs);
+
+    // payment votes are not kept for older blocks, so neither are their payments
+    for (auto it = mapPayeePaidBlocks.begin(); it != mapPayeePaidBlocks.end(); ) {
+        std::vector<const CBlockIndex*>& vecPaidBlocks = it->second;
+        auto itKeep = vecPaidBlocks.begin();
+        while (itKeep != vecPaidBlocks.end() && (*itKeep)->nHeight <= nHeight)
+            ++itKeep;
+        vecPaidBlocks.erase(vecPaidBlocks.begin(), itKeep);
+        if(vecPaidBlocks.empty()) {
+            it = mapPayeePaidBlocks.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void CMasternodeMan::UpdateLastPaidIndex(const CBlock& block, const CBlockIndex* pindex)
+{
+    if(fLiteMode) return;
+
+    int nMaxBlocksToScanBack = mnpayments.GetStorageLimit();
+
+    // pruned here, whether the list is synced or not, as UpdateLastPaid()
+    // only runs on masternodes and RPC calls
+    LOCK(cs);
+    AddBlockPayees(block, pindex);
+    PruneBlockPayees(pindex->nHeight - nMaxBlocksToScanBack);
+}
+
+void CMasternodeMan::UndoLastPaidIndex(const CBlock& block)
+{
+    if(fLiteMode || block.vtx.empty()) return;
+
+    LOCK(cs);
+    const uint256 hashBlock = block.GetHash();
+    for (const auto& txout : block.vtx[0]->vout) {
+        auto it = mapPayeePaidBlocks.find(txout.scriptPubKey);
+        if(it == mapPayeePaidBlocks.end()) continue;
+
+        std::vector<const CBlockIndex*>& vecPaidBlocks = it->second;
+        vecPaidBlocks.erase(std::remove_if(vecPaidBlocks.begin(), vecPaidBlocks.end(),
+            [&hashBlock](const CBlockIndex* pindexPaid) { return pindexPaid->GetBlockHash() == hashBlock; }), vecPaidBlocks.end());
+        if(vecPaidBlocks.empty()) {
+            mapPayeePaidBlocks.erase(it);
+        }
+    }
+}
+
 void CMasternodeMan::UpdateLastPaid(const CBlockIndex* pindex)
 {
     LOCK2(cs_main, cs);
 
     if(fLiteMode || !masternodeSync.IsWinnersListSynced() || mapMasternodes.empty()) return;
 
+    LOCK(cs_mapMasternodeBlocks);
+
+    int nMaxBlocksToScanBack = mnpayments.GetStorageLimit();
+
     static bool IsFirstRun = true;
-    // Do full scan on first run or if we are not a masternode
-    // (MNs should update this info on every block, so limited scan should be enough for them)
-    int nMaxBlocksToScanBack = (IsFirstRun || !fMasterNode) ? mnpayments.GetStorageLimit() : LAST_PAID_SCAN_BLOCKS;
+    // Blocks connected before we started are not in the index yet, read the ones
+    // we have payment votes for once. From there on the index follows the chain.
+    if(IsFirstRun) {
+        const CBlockIndex* pindexScan = pindex;
+        for (int i = 0; pindexScan && i < nMaxBlocksToScanBack; i++, pindexScan = pindexScan->pprev) {
+            if(!mnpayments.mapMasternodeBlocks.count(pindexScan->nHeight)) continue;
+
+            CBlock block;
+            if(!ReadBlockFromDisk(block, pindexScan, Params().GetConsensus())) // shouldn't really happen
+                continue;
+            AddBlockPayees(block, pindexScan);
+        }
+    }
+
+    PruneBlockPayees(pindex->nHeight - nMaxBlocksToScanBack);
 
-    // LogPrint("mnpayments", "CMasternodeMan::UpdateLastPaid -- nHeight=%d, nMaxBlocksToScanBack=%d, IsFirstRun=%s\n",
-    //                         nCachedBlockHeight, nMaxBlocksToScanBack, IsFirstRun ? "true" : "false");
+    for (const auto& payeepair : mapPayeeMasternodes) {
+        auto it = mapPayeePaidBlocks.find(payeepair.first);
+        if(it == mapPayeePaidBlocks.end()) continue;
 
-    for (auto& mnpair: mapMasternodes) {
-        mnpair.second.UpdateLastPaid(pindex, nMaxBlocksToScanBack);
+        // as the old scan back from the tip: the newest payment on this chain
+        // that the network voted for, with at least 2 votes
+        const CBlockIndex* pindexLastPaid = nullptr;
+        for (auto rit = it->second.rbegin(); rit != it->second.rend(); ++rit) {
+            const CBlockIndex* pindexPaid = *rit;
+            if(pindexPaid->nHeight > pindex->nHeight || pindex->GetAncestor(pindexPaid->nHeight) != pindexPaid) continue;
+            if(mnpayments.mapMasternodeBlocks.count(pindexPaid->nHeight) &&
+                mnpayments.mapMasternodeBlocks[pindexPaid->nHeight].HasPayeeWithVotes(payeepair.first, 2)) {
+                pindexLastPaid = pindexPaid;
+                break;
+            }
+        }
+        if(!pindexLastPaid) continue;
+
+        for (const auto& outpoint : payeepair.second) {
+            mapMasternodes.at(outpoint).UpdateLastPaid(pindexLastPaid);
+        }
     }
 
     IsFirstRun = false;
@@ -1701,6 +1910,7 @@ void CMasternodeMan::CheckMasternode(const CPubKey& pubKeyMasternode, bool fForc
     for (auto& mnpair : mapMasternodes) {
         if (mnpair.second.pubKeyMasternode == pubKeyMasternode) {
             mnpair.second.Check(fForce);
+            UpdateSinTypeIndex(mnpair.second);
             return;
         }
     }
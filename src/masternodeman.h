@@ -7,9 +7,13 @@
 #ifndef FXTC_MASTERNODEMAN_H
 #define FXTC_MASTERNODEMAN_H
 
+#include <cachemap.h>
 #include <masternode.h>
+#include <script/saltedhasher.h>
 #include <sync.h>
 
+#include <memory>
+
 using namespace std;
 
 class CMasternodeMan;
@@ -30,8 +34,6 @@ private:
 
     static const int DSEG_UPDATE_SECONDS        = 3 * 60 * 60;
 
-    static const int LAST_PAID_SCAN_BLOCKS      = 100;
-
     static const int MIN_POSE_PROTO_VERSION     = 70203;
     static const int MAX_POSE_CONNECTIONS       = 10;
     static const int MAX_POSE_RANK              = 10;
@@ -43,6 +45,16 @@ private:
     static const int MNB_RECOVERY_WAIT_SECONDS      = 60;
     static const int MNB_RECOVERY_RETRY_SECONDS     = 3 * 60 * 60;
 
+    static const int RANK_CACHE_SIZE            = 20;
+
+    /// Masternodes ranked by score against one block hash
+    struct rank_cache_item_t
+    {
+        std::vector<COutPoint> vecOutpoints;
+        std::map<COutPoint, int> mapRank;
+    };
+    typedef std::shared_ptr<const rank_cache_item_t> rank_cache_item_ptr;
+    typedef CacheMap<std::pair<uint256, int>, rank_cache_item_ptr> rank_cache_t;
 
     // critical section to protect the inner data structures
     mutable CCriticalSection cs;
@@ -76,9 +88,49 @@ private:
 
     int64_t nLastWatchdogVoteTime;
 
+    // ranks by (block hash, min protocol), least recently used ones are pruned first
+    rank_cache_t rankCache;
+
+    // blocks that paid each payee script in height order, from the coinbases of
+    // the connected blocks the payment votes are still stored for
+    std::unordered_map<CScript, std::vector<const CBlockIndex*>, SaltedScriptHasher> mapPayeePaidBlocks;
+    // masternodes by collateral payee script, kept with mapMasternodes
+    std::unordered_map<CScript, std::set<COutPoint>, SaltedScriptHasher> mapPayeeMasternodes;
+    // masternodes by burn fund, kept with mapMasternodes
+    std::map<COutPoint, std::set<COutPoint> > mapBurnFundMasternodes;
+    // burn funds of mapBurnFundMasternodes held by more than one masternode
+    std::set<COutPoint> setSharedBurnFunds;
+    // masternodes removed for a burn fund held by an older one, banned once the list is synced
+    std::vector<CService> vecBurnFundAddrToBan;
+    // masternodes by SIN type, kept with mapMasternodes and moved by Check once the type is known
+    std::map<int, std::set<COutPoint> > mapSinTypeMasternodes;
+
     friend class CMasternodeSync;
+    friend struct CMasternodeManTest;
 
     bool GetMasternodeScores(const uint256& nBlockHash, score_pair_vec_t& vecMasternodeScoresRet, int nMinProtocol = 0);
+    void AddBlockPayees(const CBlock& block, const CBlockIndex* pindex);
+    /// Forget the payments of the blocks at nHeight and below
+    void PruneBlockPayees(int nHeight);
+
+    /// Add or remove a masternode of mapMasternodes in the indexes kept with it
+    void IndexMasternode(const CMasternode& mn);
+    void UnindexMasternode(const CMasternode& mn);
+    void RebuildIndexes();
+    /// Remove a masternode from mapMasternodes and its indexes, returns the next one
+    std::map<COutPoint, CMasternode>::iterator EraseMasternode(std::map<COutPoint, CMasternode>::iterator it);
+
+    /// Move a masternode to the index of its SIN type once Check found it
+    void UpdateSinTypeIndex(const CMasternode& mn);
+    /// Remove a masternode and the broadcasts seen from it, returns the next one
+    std::map<COutPoint, CMasternode>::iterator RemoveMasternode(std::map<COutPoint, CMasternode>::iterator it);
+    /// Keep only the masternode with the oldest sigTime of a shared burn fund
+    void RemoveBurnFundNotUniqueNodes(const COutPoint& burnfund);
+
+    /// Ranks for a block hash, scored once and then taken from rankCache until the list changes
+    bool GetCachedMasternodeRanks(const uint256& nBlockHash, int nMinProtocol, rank_cache_item_ptr& ranksRet);
+    /// Must be called whenever masternodes are added or removed, or their protocol version changes
+    void InvalidateRankCache() { rankCache.Clear(); }
 
 public:
     // Keep track of all broadcasts I've seen
@@ -116,6 +168,9 @@ public:
 
         READWRITE(mapSeenMasternodeBroadcast);
         READWRITE(mapSeenMasternodePing);
+        if(ser_action.ForRead()) {
+            RebuildIndexes();
+        }
         if(ser_action.ForRead() && (strVersion != SERIALIZATION_VERSION_STRING)) {
             Clear();
         }
@@ -138,7 +193,11 @@ public:
 
     /// Check all Masternodes
     void Check();
+    /// Refresh burn fund information of Masternodes whose outpoints are spent or created by a connected or disconnected block
+    void InvalidateInfinityNodeInfo(const CBlock& block);
+    /// Ban the masternodes Add() removed for a burn fund held by an older one
     void CheckAndRemoveBurnFundNotUniqueNode(CConnman& connman);
+    /// Remove the newest masternodes of nSinType once there are more than nLimit of them
     void CheckAndRemoveLimitNumberNode(CConnman& connman, int nSinType, int nLimit);
     /// Check all Masternodes and remove inactive
     void CheckAndRemove(CConnman& connman);
@@ -210,6 +269,10 @@ public:
     bool CheckMnbAndUpdateMasternodeList(CNode* pfrom, CMasternodeBroadcast mnb, int& nDos, CConnman& connman);
     bool IsMnbRecoveryRequested(const uint256& hash) { return mMnbRecoveryRequests.count(hash); }
 
+    /// Index the masternode payments in the coinbase of a connected block
+    void UpdateLastPaidIndex(const CBlock& block, const CBlockIndex* pindex);
+    /// Remove the payments of a disconnected block from the index
+    void UndoLastPaidIndex(const CBlock& block);
     void UpdateLastPaid(const CBlockIndex* pindex);
 
     void AddDirtyGovernanceObjectHash(const uint256& nHash)
@@ -42,6 +42,7 @@
 #include <validation.h>
 
 #include <algorithm>
+#include <atomic>
 #include <queue>
 #include <utility>
 
@@ -535,105 +536,221 @@ static bool ProcessBlockFound(const std::shared_ptr<const CBlock> &pblock, const
     return true;
 }
 
-void static SINMiner(const CChainParams& chainparams, CConnman& connman)
+namespace {
+
+/** Milliseconds over which each miner thread measures its hash rate */
+const int64_t MINER_RATE_WINDOW_MS = 4000;
+
+/** Hash counter of one miner thread. Only that thread writes it, so readers
+ *  can load it without locking. */
+struct CMinerThreadStats
 {
-    LogPrintf("SINminer -- started\n");
-    RenameThread("SIN-miner");
+    //! Hash rate over the thread's last full rate window
+    std::atomic<uint64_t> nHashesPerSec{0};
+};
 
-    std::vector<std::shared_ptr<CWallet>> wallets = GetWallets();
-    CWallet * const pwallet = (wallets.size() > 0) ? wallets[0].get() : nullptr;
+CCriticalSection cs_minerStats;
+std::vector<std::shared_ptr<CMinerThreadStats>> vMinerStats GUARDED_BY(cs_minerStats);
 
-    unsigned int nExtraNonce = 0;
+/** A block template and the tip it builds on */
+struct CMinerWork
+{
+    uint64_t nId;
+    CBlock block;
+    const CBlockIndex* pindexPrev;
+    int64_t nCreated;
+};
+
+/** The block template shared by all miner threads. It is rebuilt when a
+ *  thread runs out of work on it, or is notified stale when the tip
+ *  changes (or the mempool changed and the template is over a minute old),
+ *  so the threads need not poll the chain.
+ */
+class CMinerTemplate final : public CValidationInterface
+{
+public:
+    CMinerTemplate(const CChainParams& chainparamsIn, std::shared_ptr<CReserveScript> coinbaseScriptIn)
+        : chainparams(chainparamsIn), coinbaseScript(coinbaseScriptIn) {}
 
-    std::shared_ptr<CReserveScript> coinbaseScript;
-    pwallet->GetScriptForMining(coinbaseScript);
+    /** Return a template other than the one with nKnownId, building a new
+     *  one if no other thread has yet. Returns null if that failed. */
+    std::shared_ptr<const CMinerWork> GetWork(uint64_t nKnownId)
+    {
+        LOCK(cs);
+        if (pwork && pwork->nId != nKnownId)
+            return pwork;
+
+        fTipChanged = false;
+        fMempoolChanged = false;
+        CBlockIndex* pindexPrev = chainActive.Tip();
+        if (!pindexPrev)
+            return nullptr;
+
+        BlockAssembler assembler(chainparams);
+        auto pblocktemplate = assembler.CreateNewBlock(coinbaseScript->reserveScript, true);
+        if (!pblocktemplate.get())
+        {
+            LogPrintf("SINMiner -- Keypool ran out, please call keypoolrefill before restarting the mining thread\n");
+            return nullptr;
+        }
+        auto pnew = std::make_shared<CMinerWork>();
+        pnew->nId = ++nLastId;
+        pnew->block = pblocktemplate->block;
+        pnew->pindexPrev = pindexPrev;
+        pnew->nCreated = GetTime();
+        IncrementExtraNonce(&pnew->block, pindexPrev, nExtraNonce);
+
+        LogPrintf("SINMiner -- Running miner with %u transactions in block (%u bytes)\n", pnew->block.vtx.size(),
+                  ::GetSerializeSize(pnew->block, SER_NETWORK, PROTOCOL_VERSION));
+        nCurrentId = pnew->nId;
+        pwork = pnew;
+        return pwork;
+    }
 
-    while (true) {
-        try {
+    /** Whether threads mining work should drop it for a new template */
+    bool IsStale(const CMinerWork& work) const
+    {
+        return work.nId != nCurrentId || fTipChanged ||
+               (fMempoolChanged && GetTime() - work.nCreated > 60);
+    }
+
+    /** Keep the coinbase key once it has been paid */
+    void KeepScript()
+    {
+        LOCK(cs);
+        coinbaseScript->KeepScript();
+    }
+
+protected:
+    void UpdatedBlockTip(const CBlockIndex* pindexNew, const CBlockIndex* pindexFork, bool fInitialDownload) override
+    {
+        fTipChanged = true;
+    }
+
+    void TransactionAddedToMempool(const CTransactionRef& ptxn) override
+    {
+        fMempoolChanged = true;
+    }
+
+private:
+    const CChainParams& chainparams;
+
+    CCriticalSection cs;
+    std::shared_ptr<CReserveScript> coinbaseScript GUARDED_BY(cs);
+    std::shared_ptr<const CMinerWork> pwork GUARDED_BY(cs);
+    uint64_t nLastId GUARDED_BY(cs) = 0;
+    unsigned int nExtraNonce GUARDED_BY(cs) = 0;
+
+    std::atomic<uint64_t> nCurrentId{0};
+    std::atomic<bool> fTipChanged{false};
+    std::atomic<bool> fMempoolChanged{false};
+};
+
+} // namespace
+
+void static SINMiner(const CChainParams& chainparams, CConnman& connman, std::shared_ptr<CMinerTemplate> minerTemplate,
+                     std::shared_ptr<CMinerThreadStats> stats, int nThread, int nThreads)
+{
+    LogPrintf("SINminer -- started\n");
+    RenameThread("SIN-miner");
 
-            MilliSleep(1000);
+    // All threads mine the same template, so each scans its own slice of
+    // the nonces, in whole 256 nonce rounds
+    const uint32_t nNonceBegin = ((uint64_t)nThread << 32) / nThreads & ~0xFFu;
+    const uint32_t nNonceEnd = nThread + 1 == nThreads ? 0xffff0000 : ((uint64_t)(nThread + 1) << 32) / nThreads & ~0xFFu;
 
-            // Throw an error if no script was provided.  This can happen
-            // due to some internal error but also if the keypool is empty.
-            // In the latter case, already the pointer is NULL.
-            if (!coinbaseScript || coinbaseScript->reserveScript.empty())
-                throw std::runtime_error("No coinbase script available (mining requires a wallet)");
+    uint64_t nKnownWork = 0;
+    int64_t nRateStart = GetTimeMillis();
+    uint64_t nRateHashes = 0;
 
+    while (true) {
+        try {
             do {
                 bool fvNodesEmpty = connman.GetNodeCount(CConnman::CONNECTIONS_ALL) == 0;
                 if (!fvNodesEmpty && !IsInitialBlockDownload() && masternodeSync.IsSynced())
                     break;
+                stats->nHashesPerSec.store(0, std::memory_order_relaxed);
                 MilliSleep(1000);
+                nRateStart = GetTimeMillis();
+                nRateHashes = 0;
             } while (true);
 
             //
-            // Create new block
+            // Get the shared block template
             //
-            unsigned int nTransactionsUpdatedLast = mempool.GetTransactionsUpdated();
-            CBlockIndex* pindexPrev = chainActive.Tip();
-            if(!pindexPrev) break;
-
-            BlockAssembler assembler(chainparams);
-            auto pblocktemplate = assembler.CreateNewBlock(coinbaseScript->reserveScript,  true);
-            if (!pblocktemplate.get())
+            std::shared_ptr<const CMinerWork> pwork = minerTemplate->GetWork(nKnownWork);
+            if (!pwork)
             {
-                LogPrintf("SINMiner -- Keypool ran out, please call keypoolrefill before restarting the mining thread\n");
                 MilliSleep(5000);
                 continue;
             }
-            auto pblock = std::make_shared<CBlock>(pblocktemplate->block);
-            IncrementExtraNonce(pblock.get(), pindexPrev, nExtraNonce);
-
-            LogPrintf("SINMiner -- Running miner with %u transactions in block (%u bytes)\n", pblock->vtx.size(),
-                      ::GetSerializeSize(*pblock, SER_NETWORK, PROTOCOL_VERSION));
+            nKnownWork = pwork->nId;
+            auto pblock = std::make_shared<CBlock>(pwork->block);
+            pblock->nNonce = nNonceBegin;
 
             //
             // Search
             //
-            int64_t nStart = GetTime();
-            arith_uint256 hashTarget = arith_uint256().SetCompact(pblock->nBits);
             while (true)
             {
                 unsigned int nHashesDone = 0;
+                bool fFound = false;
 
-                uint256 hash;
+                // Only the nonce changes until the next round, so hash the
+                // rest of the header once and scan nonces in batches
+                const CBlockHeaderMidstate midstate(*pblock, pwork->pindexPrev->nHeight + 1);
+                arith_uint256 hashTarget = arith_uint256().SetCompact(pblock->nBits);
+                uint256 hashes[CBlockHeaderMidstate::NONCE_BATCH_SIZE];
                 while (true)
                 {
-                    hash = pblock->GetPoWHash(chainActive.Height()+1);
-                    if (UintToArith256(hash) <= hashTarget)
+                    size_t nCount = std::min<size_t>(CBlockHeaderMidstate::NONCE_BATCH_SIZE, 0x100 - (pblock->nNonce & 0xFF));
+                    midstate.GetPoWHashes(pblock->nNonce, nCount, hashes);
+                    size_t i = 0;
+                    while (i < nCount && UintToArith256(hashes[i]) > hashTarget)
+                        ++i;
+                    pblock->nNonce += i;
+                    nHashesDone += i;
+                    if (i < nCount)
                     {
                         // Found a solution
-                        LogPrintf("SINminer:\n  proof-of-work found\n  hash: %s\n  target: %s\n", hash.GetHex(), hashTarget.GetHex());
+                        LogPrintf("SINminer:\n  proof-of-work found\n  hash: %s\n  target: %s\n", hashes[i].GetHex(), hashTarget.GetHex());
                         ProcessBlockFound(pblock, chainparams);
-                        coinbaseScript->KeepScript();
+                        minerTemplate->KeepScript();
 
                         // In regression test mode, stop mining after a block is found. This
                         // allows developers to controllably generate a block on demand.
                         if (chainparams.MineBlocksOnDemand())
                             throw boost::thread_interrupted();
 
+                        fFound = true;
                         break;
                     }
-                    pblock->nNonce += 1;
-                    nHashesDone += 1;
                     if ((pblock->nNonce & 0xFF) == 0)
                         break;
                 }
 
+                nRateHashes += nHashesDone;
+                int64_t nNow = GetTimeMillis();
+                if (nNow - nRateStart >= MINER_RATE_WINDOW_MS) {
+                    stats->nHashesPerSec.store(nRateHashes * 1000 / (nNow - nRateStart), std::memory_order_relaxed);
+                    nRateStart = nNow;
+                    nRateHashes = 0;
+                }
+
                 // Check for stop or if block needs to be rebuilt
                 boost::this_thread::interruption_point();
+                if (fFound)
+                    break;
                 // Regtest mode doesn't require peers
                 if (connman.GetNodeCount(CConnman::CONNECTIONS_ALL) == 0)
                     break;
-                if (pblock->nNonce >= 0xffff0000)
+                if (pblock->nNonce >= nNonceEnd)
                     break;
-                if (mempool.GetTransactionsUpdated() != nTransactionsUpdatedLast && GetTime() - nStart > 60)
-                    break;
-                if (pindexPrev != chainActive.Tip())
+                if (minerTemplate->IsStale(*pwork))
                     break;
 
                 // Update nTime every few seconds
-                if (UpdateTime(pblock.get(), chainparams.GetConsensus(), pindexPrev) < 0)
+                if (UpdateTime(pblock.get(), chainparams.GetConsensus(), pwork->pindexPrev) < 0)
                     break; // Recreate the block if the clock has run backwards,
             }
         }
@@ -653,6 +770,7 @@ void static SINMiner(const CChainParams& chainparams, CConnman& connman)
 void GenerateSINs(bool fGenerate, int nThreads, const CChainParams& chainparams, CConnman &connman)
 {
     static boost::thread_group* minerThreads = NULL;
+    static std::shared_ptr<CMinerTemplate> minerTemplate;
 
     if (nThreads < 0)
         nThreads = GetNumCores();
@@ -660,17 +778,62 @@ void GenerateSINs(bool fGenerate, int nThreads, const CChainParams& chainparams,
     if (minerThreads != NULL)
     {
         minerThreads->interrupt_all();
+        minerThreads->join_all();
         delete minerThreads;
         minerThreads = NULL;
     }
+    if (minerTemplate)
+    {
+        UnregisterValidationInterface(minerTemplate.get());
+        // callbacks queued before unregistering may still be running
+        SyncWithValidationInterfaceQueue();
+        minerTemplate.reset();
+    }
+    {
+        LOCK(cs_minerStats);
+        vMinerStats.clear();
+    }
 
     if (nThreads == 0 || !fGenerate)
         return;
 
-    std::string walletName = "*";
+    std::vector<std::shared_ptr<CWallet>> wallets = GetWallets();
+    CWallet * const pwallet = (wallets.size() > 0) ? wallets[0].get() : nullptr;
+
+    // Throw an error if no script was provided.  This can happen
+    // due to some internal error but also if the keypool is empty.
+    // In the latter case, already the pointer is NULL.
+    std::shared_ptr<CReserveScript> coinbaseScript;
+    if (pwallet)
+        pwallet->GetScriptForMining(coinbaseScript);
+    if (!coinbaseScript || coinbaseScript->reserveScript.empty())
+    {
+        LogPrintf("SINMiner -- runtime error: No coinbase script available (mining requires a wallet)\n");
+        return;
+    }
+
+    minerTemplate = std::make_shared<CMinerTemplate>(chainparams, coinbaseScript);
+    RegisterValidationInterface(minerTemplate.get());
+
     minerThreads = new boost::thread_group();
     for (int i = 0; i < nThreads; i++)
-        minerThreads->create_thread(boost::bind(&SINMiner, boost::cref(chainparams), boost::ref(connman)));
+    {
+        auto stats = std::make_shared<CMinerThreadStats>();
+        {
+            LOCK(cs_minerStats);
+            vMinerStats.push_back(stats);
+        }
+        minerThreads->create_thread(boost::bind(&SINMiner, boost::cref(chainparams), boost::ref(connman), minerTemplate, stats, i, nThreads));
+    }
+}
+
+std::vector<uint64_t> GetMinerHashesPerSec()
+{
+    LOCK(cs_minerStats);
+    std::vector<uint64_t> vRates;
+    for (const auto& stats : vMinerStats)
+        vRates.push_back(stats->nHashesPerSec.load(std::memory_order_relaxed));
+    return vRates;
 }
 
 void IncrementExtraNonce(CBlock* pblock, const CBlockIndex* pindexPrev, unsigned int& nExtraNonce)
@@ -202,6 +202,8 @@ private:
 
 /** Run the miner threads */
 void GenerateSINs(bool fGenerate, int nThreads, const CChainParams& chainparams, CConnman &connman);
+/** Hash rate of each running miner thread, in hashes per second */
+std::vector<uint64_t> GetMinerHashesPerSec();
 
 /** Modify the extranonce in a block */
 void IncrementExtraNonce(CBlock* pblock, const CBlockIndex* pindexPrev, unsigned int& nExtraNonce);
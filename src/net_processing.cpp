@@ -2982,6 +2982,22 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
             ReadCompactSize(vRecv); // ignore tx count; assume it is 0.
         }
 
+        // Hash the batch on the header checking threads while this thread
+        // still owns it; ProcessHeadersMessage() then finds X22I/X25X
+        // memoized on every header. A failure is reported against the
+        // offending header by ProcessNewBlockHeaders().
+        if (nCount > 1) {
+            int nFirstHeight = -1;
+            {
+                LOCK(cs_main);
+                const CBlockIndex *pindexPrev = LookupBlockIndex(headers[0].hashPrevBlock);
+                if (pindexPrev)
+                    nFirstHeight = pindexPrev->nHeight + 1;
+            }
+            if (nFirstHeight >= 0)
+                CheckBlockHeadersPoW(headers, nFirstHeight, chainparams.GetConsensus());
+        }
+
         // Headers received via a HEADERS message should be valid, and reflect
         // the chain the peer is on. If we receive a known-invalid header,
         // disconnect the peer if it is using one of our outbound connection
@@ -2995,6 +3011,18 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
         std::shared_ptr<CBlock> pblock = std::make_shared<CBlock>();
         vRecv >> *pblock;
 
+        // Hash the block while this thread is its only owner, so
+        // validation finds X22I/X25X memoized instead of rehashing it.
+        // cs_main is only held for the height lookup, not the hashing.
+        int nBlockHeight = -1;
+        {
+            LOCK(cs_main);
+            const CBlockIndex *pindexPrev = LookupBlockIndex(pblock->hashPrevBlock);
+            if (pindexPrev)
+                nBlockHeight = pindexPrev->nHeight + 1;
+        }
+        pblock->CacheHashes(nBlockHeight);
+
         LogPrint(BCLog::NET, "received block %s peer=%d\n", pblock->GetHash().ToString(), pfrom->GetId());
 
         bool forceProcessing = false;
@@ -6,6 +6,7 @@
 #include <primitives/block.h>
 
 #include <chainparams.h>
+#include <crypto/x25x.h>
 #include <hash.h>
 #include <tinyformat.h>
 #include <utilstrencodings.h>
@@ -15,24 +16,129 @@ const int nSinHeightFinalnet = 5;
 const int nSinHeightTestnet  = 5;
 const int nSinHeightMainnet  = 170000;
 
+bool CBlockHeader::IsHashCacheCurrent() const
+{
+    return memcmp(vchHashedHeader, BEGIN(nVersion), sizeof(vchHashedHeader)) == 0;
+}
+
 uint256 CBlockHeader::GetHash() const
 {
+    // Shared blocks are hashed from several threads at once, so only read
+    // what CacheHashes() or PrecomputeHashes() stored before the header was
+    // handed out.
+    if (fHashed && IsHashCacheCurrent())
+        return hashBlockCached;
     return HashX22I(BEGIN(nVersion), END(nNonce));
 }
 
+static bool IsSinPoWHeight(int nHeight)
+{
+    return (Params().NetworkIDString() == CBaseChainParams::MAIN && nHeight >= nSinHeightMainnet) ||
+           (Params().NetworkIDString() == CBaseChainParams::TESTNET && nHeight >= nSinHeightTestnet) ||
+           (Params().NetworkIDString() == CBaseChainParams::FINALNET && nHeight >= nSinHeightFinalnet);
+}
+
+uint256 CBlockHeader::GetCachedPoWHash(int nHeight) const
+{
+    if (fCheckedPoW && fPoWSinMode == IsSinPoWHeight(nHeight) && IsHashCacheCurrent())
+        return hashPoW;
+    return uint256();
+}
+
 uint256 CBlockHeader::GetPoWHash(int nHeight) const
 {
-    bool fSinMode = false;
+    bool fSinMode = IsSinPoWHeight(nHeight);
 
-    if ((Params().NetworkIDString() == CBaseChainParams::MAIN && nHeight >= nSinHeightMainnet) ||
-        (Params().NetworkIDString() == CBaseChainParams::TESTNET && nHeight >= nSinHeightTestnet) ||
-        (Params().NetworkIDString() == CBaseChainParams::FINALNET && nHeight >= nSinHeightFinalnet))
-        fSinMode = true;
+    if (fCheckedPoW && fPoWSinMode == fSinMode && IsHashCacheCurrent())
+        return hashPoW;
 
     if (!fSinMode)
-        return HashX22I(BEGIN(nVersion), END(nNonce));
+        return GetHash();
+    return HashX25X(BEGIN(nVersion), END(nNonce));
+}
+
+void CBlockHeader::CacheHashes(int nHeight)
+{
+    memcpy(vchHashedHeader, BEGIN(nVersion), sizeof(vchHashedHeader));
+    hashBlockCached = HashX22I(BEGIN(nVersion), END(nNonce));
+    fHashed = true;
+    fCheckedPoW = nHeight >= 0;
+    if (fCheckedPoW) {
+        fPoWSinMode = IsSinPoWHeight(nHeight);
+        hashPoW = fPoWSinMode ? HashX25X(BEGIN(nVersion), END(nNonce)) : hashBlockCached;
+    }
+}
+
+void CBlockHeader::SetCachedHashes(const uint256& hash, const uint256& powHash, int nHeight)
+{
+    memcpy(vchHashedHeader, BEGIN(nVersion), sizeof(vchHashedHeader));
+    hashBlockCached = hash;
+    fHashed = true;
+    fCheckedPoW = !powHash.IsNull();
+    if (fCheckedPoW) {
+        fPoWSinMode = IsSinPoWHeight(nHeight);
+        hashPoW = powHash;
+    }
+}
+
+void CBlockHeader::PrecomputeHashes(CBlockHeader* headers, size_t count, int nFirstHeight)
+{
+    static const size_t HEADER_SIZE = 80;
+    typedef unsigned char (*HashBytes)[32];
+
+    std::vector<unsigned char> data(count * HEADER_SIZE);
+    for (size_t i = 0; i < count; ++i) {
+        memcpy(&data[i * HEADER_SIZE], BEGIN(headers[i].nVersion), HEADER_SIZE);
+    }
+
+    std::vector<uint256> hashes(count);
+    CX22IHasher::HashBatch(data.data(), HEADER_SIZE, count, (HashBytes)hashes.data());
+
+    // X25X is only needed from the first header at a SIN height on
+    size_t nFirstSin = 0;
+    while (nFirstSin < count && !IsSinPoWHeight(nFirstHeight + nFirstSin))
+        ++nFirstSin;
+    std::vector<uint256> powHashes(count - nFirstSin);
+    CX25XHasher::HashBatch(&data[nFirstSin * HEADER_SIZE], HEADER_SIZE, count - nFirstSin, (HashBytes)powHashes.data());
+
+    for (size_t i = 0; i < count; ++i) {
+        CBlockHeader& header = headers[i];
+        memcpy(header.vchHashedHeader, BEGIN(header.nVersion), HEADER_SIZE);
+        header.hashBlockCached = hashes[i];
+        header.fHashed = true;
+        header.fPoWSinMode = i >= nFirstSin;
+        header.hashPoW = header.fPoWSinMode ? powHashes[i - nFirstSin] : hashes[i];
+        header.fCheckedPoW = true;
+    }
+}
+
+const size_t CBlockHeaderMidstate::NONCE_BATCH_SIZE;
+
+CBlockHeaderMidstate::CBlockHeaderMidstate(const CBlockHeader& header, int nHeight)
+{
+    fSinMode = IsSinPoWHeight(nHeight);
+    const size_t nPrefixSize = BEGIN(header.nNonce) - BEGIN(header.nVersion);
+    if (fSinMode)
+        hasherX25X.Write((const unsigned char*)BEGIN(header.nVersion), nPrefixSize);
+    else
+        hasherX22I.Write((const unsigned char*)BEGIN(header.nVersion), nPrefixSize);
+}
+
+uint256 CBlockHeaderMidstate::GetPoWHash(uint32_t nNonce) const
+{
+    uint256 hash;
+    GetPoWHashes(nNonce, 1, &hash);
+    return hash;
+}
+
+void CBlockHeaderMidstate::GetPoWHashes(uint32_t nNonce, size_t count, uint256* hashes) const
+{
+    typedef unsigned char (*HashBytes)[32];
+
+    if (fSinMode)
+        hasherX25X.FinalizeNonces(nNonce, count, (HashBytes)hashes);
     else
-        return HashX25X(BEGIN(nVersion), END(nNonce));
+        hasherX22I.FinalizeNonces(nNonce, count, (HashBytes)hashes);
 }
 
 std::string CBlock::ToString() const
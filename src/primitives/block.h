@@ -6,6 +6,7 @@
 #ifndef BITCOIN_PRIMITIVES_BLOCK_H
 #define BITCOIN_PRIMITIVES_BLOCK_H
 
+#include <crypto/x25x.h>
 #include <primitives/transaction.h>
 #include <serialize.h>
 #include <uint256.h>
@@ -32,6 +33,19 @@ public:
     uint32_t nBits;
     uint32_t nNonce;
 
+    // memory only
+    //! Header bytes the memoized hashes below were computed from. Only
+    //! CacheHashes() and PrecomputeHashes() store them; the const getters
+    //! never write, as blocks are shared between threads.
+    unsigned char vchHashedHeader[80];
+    //! Set once hashBlockCached holds GetHash() for vchHashedHeader
+    bool fHashed;
+    uint256 hashBlockCached;
+    //! Set once hashPoW holds GetPoWHash() for vchHashedHeader
+    bool fCheckedPoW;
+    bool fPoWSinMode;
+    uint256 hashPoW;
+
     CBlockHeader()
     {
         SetNull();
@@ -57,6 +71,8 @@ public:
         nTime = 0;
         nBits = 0;
         nNonce = 0;
+        fHashed = false;
+        fCheckedPoW = false;
     }
 
     bool IsNull() const
@@ -68,10 +84,55 @@ public:
 
     uint256 GetPoWHash(int nHeight) const;
 
+    //! Return the memoized GetPoWHash() result if it is still current, null otherwise
+    uint256 GetCachedPoWHash(int nHeight) const;
+
+    //! Memoize GetHash(), and GetPoWHash() too if the height nHeight is known
+    //! (not negative). Call it before the header is visible to other threads.
+    void CacheHashes(int nHeight = -1);
+
+    //! Memoize a GetHash() and GetPoWHash() at height nHeight that are already
+    //! known, e.g. from the block index, without hashing. A null powHash only
+    //! memoizes GetHash(). Same threading rules as CacheHashes().
+    void SetCachedHashes(const uint256& hash, const uint256& powHash, int nHeight);
+
+    //! Memoize GetHash() and GetPoWHash() of count consecutive headers, the
+    //! first one at nFirstHeight, hashing them in batches. The headers must
+    //! not be visible to other threads yet.
+    static void PrecomputeHashes(CBlockHeader* headers, size_t count, int nFirstHeight);
+
     int64_t GetBlockTime() const
     {
         return (int64_t)nTime;
     }
+
+private:
+    //! Whether no header field changed since the memoized hashes were computed
+    bool IsHashCacheCurrent() const;
+};
+
+/** The proof of work hash of a header for any nonce. The header bytes before
+ *  the nonce are fed to the first hash stage once, so scanning nonces only
+ *  hashes the trailing four bytes per attempt.
+ */
+class CBlockHeaderMidstate
+{
+public:
+    //! Nonces GetPoWHashes() pushes through the hash chain together
+    static const size_t NONCE_BATCH_SIZE = 8;
+
+    CBlockHeaderMidstate(const CBlockHeader& header, int nHeight);
+
+    //! GetPoWHash() of the header with nNonce set
+    uint256 GetPoWHash(uint32_t nNonce) const;
+
+    //! GetPoWHash() of the header for count consecutive nonces from nNonce
+    void GetPoWHashes(uint32_t nNonce, size_t count, uint256* hashes) const;
+
+private:
+    bool fSinMode;
+    CX22IHasher hasherX22I;
+    CX25XHasher hasherX25X;
 };
 
 
@@ -118,14 +179,8 @@ public:
 
     CBlockHeader GetBlockHeader() const
     {
-        CBlockHeader block;
-        block.nVersion       = nVersion;
-        block.hashPrevBlock  = hashPrevBlock;
-        block.hashMerkleRoot = hashMerkleRoot;
-        block.nTime          = nTime;
-        block.nBits          = nBits;
-        block.nNonce         = nNonce;
-        return block;
+        // Keeps the memoized proof of work hash along with the header fields
+        return *this;
     }
 
     std::string ToString() const;
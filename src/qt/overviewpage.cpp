@@ -198,8 +198,9 @@ OverviewPage::~OverviewPage()
 
 void OverviewPage::infinityNodeStat()
 {
-    std::map<COutPoint, CInfinitynode> mapInfinitynodes = infnodeman.GetFullInfinitynodeMap();
-    std::map<COutPoint, CInfinitynode> mapInfinitynodesNonMatured = infnodeman.GetFullInfinitynodeNonMaturedMap();
+    std::shared_ptr<const CInfinitynodeSnapshot> snapshot = infnodeman.GetSnapshot();
+    const std::map<COutPoint, CInfinitynode>& mapInfinitynodes = snapshot->mapInfinitynodes;
+    const std::map<COutPoint, CInfinitynode>& mapInfinitynodesNonMatured = snapshot->mapInfinitynodesNonMatured;
     int total = 0, totalBIG = 0, totalMID = 0, totalLIL = 0, totalUnknown = 0;
     for (auto& infpair : mapInfinitynodes) {
         ++total;
@@ -853,9 +853,11 @@ UniValue infinitynode(const JSONRPCRequest& request)
 
     if (strCommand == "build-stm")
     {
-            return infnodeman.deterministicRewardStatement(10) &&
-                   infnodeman.deterministicRewardStatement(5) &&
-                   infnodeman.deterministicRewardStatement(1);
+            bool updateStm = infnodeman.deterministicRewardStatement(10) &&
+                             infnodeman.deterministicRewardStatement(5) &&
+                             infnodeman.deterministicRewardStatement(1);
+            infnodeman.calculAllInfinityNodesRankAtLastStm();
+            return updateStm;
     }
 
     if (strCommand == "show-stm")
@@ -892,8 +894,8 @@ UniValue infinitynode(const JSONRPCRequest& request)
 
     if (strCommand == "show-lastpaid")
     {
-        std::map<CScript, int>  mapLastPaid = infnodeman.GetFullLastPaidMap();
-        for (auto& pair : mapLastPaid) {
+        std::shared_ptr<const CInfinitynodeSnapshot> snapshot = infnodeman.GetSnapshot();
+        for (auto& pair : snapshot->mapLastPaid) {
             std::string scriptPublicKey = pair.first.ToString();
             obj.push_back(Pair(scriptPublicKey, pair.second));
         }
@@ -902,8 +904,8 @@ UniValue infinitynode(const JSONRPCRequest& request)
 
     if (strCommand == "show-infos")
     {
-        std::map<COutPoint, CInfinitynode> mapInfinitynodes = infnodeman.GetFullInfinitynodeMap();
-        for (auto& infpair : mapInfinitynodes) {
+        std::shared_ptr<const CInfinitynodeSnapshot> snapshot = infnodeman.GetSnapshot();
+        for (auto& infpair : snapshot->mapInfinitynodes) {
             std::string strOutpoint = infpair.first.ToStringShort();
             CInfinitynode inf = infpair.second;
                 std::ostringstream streamInfo;
@@ -924,8 +926,8 @@ UniValue infinitynode(const JSONRPCRequest& request)
 
     if (strCommand == "show-script")
     {
-        std::map<COutPoint, CInfinitynode> mapInfinitynodes = infnodeman.GetFullInfinitynodeMap();
-        for (auto& infpair : mapInfinitynodes) {
+        std::shared_ptr<const CInfinitynodeSnapshot> snapshot = infnodeman.GetSnapshot();
+        for (auto& infpair : snapshot->mapInfinitynodes) {
             std::string strOutpoint = infpair.first.ToStringShort();
             CInfinitynode inf = infpair.second;
                 std::ostringstream streamInfo;
@@ -1006,9 +1008,9 @@ static UniValue infinitynodeburnfund(const JSONRPCRequest& request)
     if (!IsValidDestination(BKaddress))
         throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid SIN address for Backup");
 
-    std::map<COutPoint, CInfinitynode> mapInfinitynodes = infnodeman.GetFullInfinitynodeMap();
+    std::shared_ptr<const CInfinitynodeSnapshot> snapshot = infnodeman.GetSnapshot();
     int totalNode = 0, totalBIG = 0, totalMID = 0, totalLIL = 0, totalUnknown = 0;
-    for (auto& infpair : mapInfinitynodes) {
+    for (auto& infpair : snapshot->mapInfinitynodes) {
         ++totalNode;
         CInfinitynode inf = infpair.second;
         int sintype = inf.getSINType();
@@ -1085,7 +1087,7 @@ static UniValue infinitynodeburnfund(const JSONRPCRequest& request)
         entry.pushKV("safe", out.fSafe);
         if (out.tx->tx->vout[out.i].nValue >= nAmount && out.nDepth >= 2) {
             /*check address is unique*/
-            for (auto& infpair : mapInfinitynodes) {
+            for (auto& infpair : snapshot->mapInfinitynodes) {
                 CInfinitynode inf = infpair.second;
                 if(inf.getCollateralAddress() == EncodeDestination(address)){
                     strError = strprintf("Error: Address %s exist in list. Please use another address to make sure it is unique.", EncodeDestination(address));
@@ -32,8 +32,12 @@
 #include <masternode-sync.h>
 //
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
+#include <numeric>
 #include <stdint.h>
+#include <thread>
 
 unsigned int ParseConfirmTarget(const UniValue& value)
 {
@@ -109,6 +113,45 @@ static UniValue getnetworkhashps(const JSONRPCRequest& request)
     return GetNetworkHashPS(!request.params[0].isNull() ? request.params[0].get_int() : 120, !request.params[1].isNull() ? request.params[1].get_int() : -1);
 }
 
+/** Find the lowest nonce in [nBegin, nEnd) for which the header passes its
+ *  proof of work check, searching on nThreads threads. Returns nEnd if there
+ *  is none. Threads claim batches of nonces in increasing order and stop once
+ *  a lower nonce has been found, so the result is the same for any nThreads.
+ */
+static uint32_t FindNonce(const CBlockHeaderMidstate& midstate, uint32_t nBits, uint32_t nBegin, uint32_t nEnd, int nThreads)
+{
+    const uint32_t nBatchSize = CBlockHeaderMidstate::NONCE_BATCH_SIZE;
+    std::atomic<uint64_t> nNextBatch{nBegin};
+    std::atomic<uint32_t> nFound{nEnd};
+
+    auto search = [&]() {
+        uint256 hashes[CBlockHeaderMidstate::NONCE_BATCH_SIZE];
+        while (true) {
+            uint64_t nBatch = nNextBatch.fetch_add(nBatchSize);
+            if (nBatch >= nFound.load())
+                break;
+            size_t nCount = std::min<uint64_t>(nBatchSize, nEnd - nBatch);
+            midstate.GetPoWHashes(nBatch, nCount, hashes);
+            for (size_t i = 0; i < nCount; ++i) {
+                if (CheckProofOfWork(hashes[i], nBits, Params().GetConsensus())) {
+                    uint32_t nNonce = nBatch + i;
+                    uint32_t nPrev = nFound.load();
+                    while (nNonce < nPrev && !nFound.compare_exchange_weak(nPrev, nNonce)) {}
+                    break;
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < nThreads; ++i)
+        threads.emplace_back(search);
+    search();
+    for (std::thread& thread : threads)
+        thread.join();
+    return nFound;
+}
+
 UniValue generateBlocks(std::shared_ptr<CReserveScript> coinbaseScript, int nGenerate, uint64_t nMaxTries, bool keepScript)
 {
     static const int nInnerLoopCount = 0x10000;
@@ -120,6 +163,9 @@ UniValue generateBlocks(std::shared_ptr<CReserveScript> coinbaseScript, int nGen
         nHeight = chainActive.Height();
         nHeightEnd = nHeight+nGenerate;
     }
+    int nThreads = gArgs.GetArg("-generatethreads", DEFAULT_GENERATE_THREADS);
+    if (nThreads <= 0)
+        nThreads = GetNumCores();
     unsigned int nExtraNonce = 0;
     UniValue blockHashes(UniValue::VARR);
     while (nHeight < nHeightEnd && !ShutdownRequested())
@@ -132,10 +178,13 @@ UniValue generateBlocks(std::shared_ptr<CReserveScript> coinbaseScript, int nGen
             LOCK(cs_main);
             IncrementExtraNonce(pblock, chainActive.Tip(), nExtraNonce);
         }
-        while (nMaxTries > 0 && pblock->nNonce < nInnerLoopCount && !CheckProofOfWork(pblock->GetPoWHash(nHeight + 1), pblock->nBits, Params().GetConsensus())) {
-            ++pblock->nNonce;
-            --nMaxTries;
-        }
+        // Hash the header up to the nonce once, then try the nonces up to
+        // nInnerLoopCount, or as many as nMaxTries allows
+        const CBlockHeaderMidstate midstate(*pblock, nHeight + 1);
+        uint32_t nEnd = pblock->nNonce + std::min<uint64_t>(nMaxTries, nInnerLoopCount - pblock->nNonce);
+        uint32_t nNonce = FindNonce(midstate, pblock->nBits, pblock->nNonce, nEnd, nThreads);
+        nMaxTries -= nNonce - pblock->nNonce;
+        pblock->nNonce = nNonce;
         if (nMaxTries == 0) {
             break;
         }
@@ -204,6 +253,9 @@ static UniValue getmininginfo(const JSONRPCRequest& request)
             "  \"currentblocktx\": nnn,     (numeric) The last block transaction\n"
             "  \"difficulty\": xxx.xxxxx    (numeric) The current difficulty\n"
             "  \"networkhashps\": nnn,      (numeric) The network hashes per second\n"
+            "  \"generate\": true|false     (boolean) If the internal miner is on\n"
+            "  \"genproclimit\": n          (numeric) The number of miner threads\n"
+            "  \"hashespersec\": n          (numeric) The hashes per second of the internal miner\n"
             "  \"pooledtx\": n              (numeric) The size of the mempool\n"
             "  \"chain\": \"xxxx\",           (string) current network name as defined in BIP70 (main, test, regtest)\n"
             "  \"warnings\": \"...\"          (string) any network and blockchain warnings\n"
@@ -222,12 +274,45 @@ static UniValue getmininginfo(const JSONRPCRequest& request)
     obj.pushKV("currentblocktx",   (uint64_t)nLastBlockTx);
     obj.pushKV("difficulty",       (double)GetDifficulty(chainActive.Tip()));
     obj.pushKV("networkhashps",    getnetworkhashps(request));
+    std::vector<uint64_t> vHashesPerSec = GetMinerHashesPerSec();
+    obj.pushKV("generate",         !vHashesPerSec.empty());
+    obj.pushKV("genproclimit",     (int)vHashesPerSec.size());
+    obj.pushKV("hashespersec",     std::accumulate(vHashesPerSec.begin(), vHashesPerSec.end(), (uint64_t)0));
     obj.pushKV("pooledtx",         (uint64_t)mempool.size());
     obj.pushKV("chain",            Params().NetworkIDString());
     obj.pushKV("warnings",         GetWarnings("statusbar"));
     return obj;
 }
 
+static UniValue gethashespersec(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 0)
+        throw std::runtime_error(
+            "gethashespersec\n"
+            "\nReturns the hashes per second of the internal miner, in total and per miner thread.\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"hashespersec\": n,         (numeric) The hashes per second of all miner threads\n"
+            "  \"threads\": [ n, ... ]      (array) The hashes per second of each miner thread\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("gethashespersec", "")
+            + HelpExampleRpc("gethashespersec", "")
+        );
+
+    uint64_t nTotal = 0;
+    UniValue threads(UniValue::VARR);
+    for (uint64_t nHashesPerSec : GetMinerHashesPerSec()) {
+        nTotal += nHashesPerSec;
+        threads.push_back(nHashesPerSec);
+    }
+
+    UniValue obj(UniValue::VOBJ);
+    obj.pushKV("hashespersec", nTotal);
+    obj.pushKV("threads", threads);
+    return obj;
+}
+
 
 // NOTE: Unlike wallet RPC (which use SIN values), mining RPCs follow GBT (BIP 22) in using satoshi amounts
 static UniValue prioritisetransaction(const JSONRPCRequest& request)
@@ -1067,6 +1152,7 @@ static const CRPCCommand commands[] =
   //  --------------------- ------------------------  -----------------------  ----------
     { "mining",             "getnetworkhashps",       &getnetworkhashps,       {"nblocks","height"} },
     { "mining",             "getmininginfo",          &getmininginfo,          {} },
+    { "mining",             "gethashespersec",        &gethashespersec,        {} },
     { "mining",             "prioritisetransaction",  &prioritisetransaction,  {"txid","dummy","fee_delta"} },
     { "mining",             "getblocktemplate",       &getblocktemplate,       {"template_request"} },
     { "mining",             "submitblock",            &submitblock,            {"hexdata","dummy"} },
@@ -9,6 +9,9 @@
 
 #include <univalue.h>
 
+/** -generatethreads default (number of nonce search threads of generate, 0 = auto) */
+static const int DEFAULT_GENERATE_THREADS = 1;
+
 /** Generate blocks (mine) */
 UniValue generateBlocks(std::shared_ptr<CReserveScript> coinbaseScript, int nGenerate, uint64_t nMaxTries, bool keepScript);
 
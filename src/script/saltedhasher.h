@@ -0,0 +1,26 @@
+// Copyright (c) 2018-2019 SIN developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef SIN_SCRIPT_SALTEDHASHER_H
+#define SIN_SCRIPT_SALTEDHASHER_H
+
+#include <hash.h>
+#include <script/script.h>
+
+/** Salted hasher for payee scripts, to key hash maps by them */
+class SaltedScriptHasher
+{
+private:
+    /** Salt */
+    uint64_t k0, k1;
+
+public:
+    SaltedScriptHasher();
+
+    size_t operator()(const CScript& script) const {
+        return CSipHasher(k0, k1).Write(script.data(), script.size()).Finalize();
+    }
+};
+
+#endif // SIN_SCRIPT_SALTEDHASHER_H
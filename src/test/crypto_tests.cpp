@@ -3,6 +3,7 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <crypto/aes.h>
+#include <crypto/common.h>
 #include <crypto/chacha20.h>
 #include <crypto/ripemd160.h>
 #include <crypto/sha1.h>
@@ -10,6 +11,11 @@
 #include <crypto/sha512.h>
 #include <crypto/hmac_sha256.h>
 #include <crypto/hmac_sha512.h>
+#include <crypto/sph_echo.h>
+#include <crypto/sph_fugue.h>
+#include <crypto/sph_groestl.h>
+#include <crypto/sph_shavite.h>
+#include <crypto/x25x.h>
 #include <random.h>
 #include <utilstrencodings.h>
 #include <test/test_sin.h>
@@ -55,6 +61,8 @@ static void TestSHA1(const std::string &in, const std::string &hexout) { TestVec
 static void TestSHA256(const std::string &in, const std::string &hexout) { TestVector(CSHA256(), in, ParseHex(hexout));}
 static void TestSHA512(const std::string &in, const std::string &hexout) { TestVector(CSHA512(), in, ParseHex(hexout));}
 static void TestRIPEMD160(const std::string &in, const std::string &hexout) { TestVector(CRIPEMD160(), in, ParseHex(hexout));}
+static void TestX22I(const std::string &hexin, const std::string &hexout) { TestVector(CX22IHasher(), ParseHex(hexin), ParseHex(hexout));}
+static void TestX25X(const std::string &hexin, const std::string &hexout) { TestVector(CX25XHasher(), ParseHex(hexin), ParseHex(hexout));}
 
 static void TestHMACSHA256(const std::string &hexkey, const std::string &hexin, const std::string &hexout) {
     std::vector<unsigned char> key = ParseHex(hexkey);
@@ -562,4 +570,123 @@ BOOST_AUTO_TEST_CASE(sha256d64)
     }
 }
 
+
+BOOST_AUTO_TEST_CASE(x22i_x25x_testvectors)
+{
+    const std::string header = "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f404142434445464748494a4b4c4d4e4f";
+    TestX22I("", "77676a5a64965d331d054a8a5f234a0137dd41621a882f7383404f02c8a153d5");
+    TestX22I("616263", "1bbed1756c24a30c3fc6a84d0d773244b0903728ecbc47844379f13337ac397f");
+    TestX22I(header, "a27e5de856e884a30c684627cb827d6b4f801b36a2377b1a55e9656eb63e4f5d");
+    TestX25X("", "6f8ae1360d3867d01e5bcee230e6247d96735e83a3ae1541594b040808ef0213");
+    TestX25X("616263", "e5a9f41ca40cb29d69e111bdc107ef336b8a7f924556ccc3521501d7612b46b0");
+    TestX25X(header, "7685a41634cb3b12580899a0d3260e787534f0c9cadab35a64ae30cf558c1e8f");
+}
+
+BOOST_AUTO_TEST_CASE(x22i_x25x_batch)
+{
+    unsigned char header[80 * 20];
+    for (unsigned char& c : header) {
+        c = InsecureRandBits(8);
+    }
+    for (size_t count = 0; count <= 20; ++count) {
+        unsigned char batch[4][20][32], single[2][32];
+
+        // Consecutive nonces over a common prefix, wrapping around
+        const uint32_t nNonce = 0xfffffff8;
+        CX22IHasher x22i;
+        x22i.Write(header, 76).FinalizeNonces(nNonce, count, batch[0]);
+        CX25XHasher x25x;
+        x25x.Write(header, 76).FinalizeNonces(nNonce, count, batch[1]);
+        for (size_t i = 0; i < count; ++i) {
+            unsigned char in[80];
+            memcpy(in, header, 76);
+            WriteLE32(in + 76, nNonce + i);
+            CX22IHasher().Write(in, 80).Finalize(single[0]);
+            CX25XHasher().Write(in, 80).Finalize(single[1]);
+            BOOST_CHECK(memcmp(batch[0][i], single[0], 32) == 0);
+            BOOST_CHECK(memcmp(batch[1][i], single[1], 32) == 0);
+        }
+
+        // Unrelated inputs
+        CX22IHasher::HashBatch(header, 80, count, batch[2]);
+        CX25XHasher::HashBatch(header, 80, count, batch[3]);
+        for (size_t i = 0; i < count; ++i) {
+            CX22IHasher().Write(header + 80 * i, 80).Finalize(single[0]);
+            CX25XHasher().Write(header + 80 * i, 80).Finalize(single[1]);
+            BOOST_CHECK(memcmp(batch[2][i], single[0], 32) == 0);
+            BOOST_CHECK(memcmp(batch[3][i], single[1], 32) == 0);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(x25x_compress_backends)
+{
+    // Whatever X25XAutoDetect() selected must match the portable code
+    void (*echo)(sph_echo_big_context*) = sph_echo_big_compress;
+    void (*fugue)(sph_fugue_context*, const void*, size_t) = sph_fugue512_words;
+    void (*fugue_final)(sph_u32*) = sph_fugue512_final;
+    void (*groestl)(sph_groestl_big_context*) = sph_groestl_big_compress;
+    void (*groestl_final)(sph_groestl_big_context*) = sph_groestl_big_final;
+    void (*shavite)(sph_shavite_big_context*, const void*) = sph_shavite_big_compress;
+    for (int i = 0; i <= 600; i += 1 + InsecureRandRange(16)) {
+        std::vector<unsigned char> in(i + 1);
+        for (unsigned char& c : in) {
+            c = InsecureRandBits(8);
+        }
+        unsigned char out[4][64];
+
+        sph_echo512_context echo_ctx;
+        sph_echo_big_compress = sph_echo_big_compress_ref;
+        sph_echo512_init(&echo_ctx);
+        sph_echo512(&echo_ctx, in.data(), i);
+        sph_echo512_close(&echo_ctx, out[0]);
+        sph_echo_big_compress = echo;
+        sph_echo512_init(&echo_ctx);
+        sph_echo512(&echo_ctx, in.data(), i);
+        sph_echo512_close(&echo_ctx, out[1]);
+        BOOST_CHECK(memcmp(out[0], out[1], 64) == 0);
+
+        sph_shavite512_context shavite_ctx;
+        sph_shavite_big_compress = sph_shavite_big_compress_ref;
+        sph_shavite512_init(&shavite_ctx);
+        sph_shavite512(&shavite_ctx, in.data(), i);
+        sph_shavite512_close(&shavite_ctx, out[2]);
+        sph_shavite_big_compress = shavite;
+        sph_shavite512_init(&shavite_ctx);
+        sph_shavite512(&shavite_ctx, in.data(), i);
+        sph_shavite512_close(&shavite_ctx, out[3]);
+        BOOST_CHECK(memcmp(out[2], out[3], 64) == 0);
+
+        // split the input so the partial words fugue buffers are covered
+        size_t split = InsecureRandRange(i + 1);
+        sph_fugue512_context fugue_ctx;
+        sph_fugue512_words = sph_fugue512_words_ref;
+        sph_fugue512_final = sph_fugue512_final_ref;
+        sph_fugue512_init(&fugue_ctx);
+        sph_fugue512(&fugue_ctx, in.data(), split);
+        sph_fugue512(&fugue_ctx, in.data() + split, i - split);
+        sph_fugue512_close(&fugue_ctx, out[0]);
+        sph_fugue512_words = fugue;
+        sph_fugue512_final = fugue_final;
+        sph_fugue512_init(&fugue_ctx);
+        sph_fugue512(&fugue_ctx, in.data(), split);
+        sph_fugue512(&fugue_ctx, in.data() + split, i - split);
+        sph_fugue512_close(&fugue_ctx, out[1]);
+        BOOST_CHECK(memcmp(out[0], out[1], 64) == 0);
+
+        sph_groestl512_context groestl_ctx;
+        sph_groestl_big_compress = sph_groestl_big_compress_ref;
+        sph_groestl_big_final = sph_groestl_big_final_ref;
+        sph_groestl512_init(&groestl_ctx);
+        sph_groestl512(&groestl_ctx, in.data(), i);
+        sph_groestl512_close(&groestl_ctx, out[2]);
+        sph_groestl_big_compress = groestl;
+        sph_groestl_big_final = groestl_final;
+        sph_groestl512_init(&groestl_ctx);
+        sph_groestl512(&groestl_ctx, in.data(), i);
+        sph_groestl512_close(&groestl_ctx, out[3]);
+        BOOST_CHECK(memcmp(out[2], out[3], 64) == 0);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
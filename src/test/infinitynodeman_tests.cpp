@@ -0,0 +1,554 @@
+// Copyright (c) 2018-2019 SIN developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <infinitynodeman.h>
+
+#include <arith_uint256.h>
+#include <chain.h>
+#include <chainparams.h>
+#include <crypto/common.h>
+#include <primitives/block.h>
+#include <script/standard.h>
+#include <test/test_sin.h>
+
+#include <algorithm>
+#include <deque>
+#include <set>
+
+#include <boost/test/unit_test.hpp>
+
+/**
+ * Block indexes with the burn funds and payees of each block, given to the
+ * manager as BlockConnected() does once it found them in the block. The
+ * blocks of several branches can be added.
+ */
+struct CInfinitynodeManTest
+{
+    static const int INF_MATURED_LIMIT = CInfinitynodeMan::INF_MATURED_LIMIT;
+
+    std::deque<CBlockHeader> vHeader;
+    std::deque<uint256> vHash;
+    std::deque<CBlockIndex> vIndex;
+    std::map<const CBlockIndex*, CInfinitynodeBlockScan> mapScan;
+
+    const CBlockIndex* AddBlock(const CBlockIndex* pprev, const CInfinitynodeBlockScan& scan = CInfinitynodeBlockScan())
+    {
+        CBlockHeader header;
+        header.hashPrevBlock = pprev ? pprev->GetBlockHash() : uint256();
+        header.nNonce = vHeader.size();
+        vHeader.push_back(header);
+        vHash.push_back(header.GetHash());
+        vIndex.emplace_back();
+        CBlockIndex& index = vIndex.back();
+        index.phashBlock = &vHash.back();
+        index.nHeight = pprev ? pprev->nHeight + 1 : 0;
+        index.pprev = const_cast<CBlockIndex*>(pprev);
+        index.BuildSkip();
+        mapScan[&index] = scan;
+        return &index;
+    }
+
+    std::shared_ptr<const CBlock> GetBlock(const CBlockIndex* pindex) const
+    {
+        for (size_t i = 0; i < vIndex.size(); ++i) {
+            if (&vIndex[i] == pindex)
+                return std::make_shared<const CBlock>(CBlock(vHeader[i]));
+        }
+        return nullptr;
+    }
+
+    void Connect(CInfinitynodeMan& man, const CBlockIndex* pindex)
+    {
+        const CInfinitynodeBlockScan& scan = mapScan.at(pindex);
+        {
+            LOCK(man.cs);
+            man.connectTip(pindex, scan.vNodes, scan.vPayees);
+        }
+        man.UpdateChainTip(pindex);
+    }
+
+    /** Connect a block the way the validation interface does */
+    void BlockConnected(CInfinitynodeMan& man, const CBlockIndex* pindex)
+    {
+        man.BlockConnected(GetBlock(pindex), pindex, {});
+    }
+
+    void Disconnect(CInfinitynodeMan& man, const CBlockIndex* pindex)
+    {
+        man.BlockDisconnected(GetBlock(pindex));
+        man.UpdateChainTip(pindex->pprev);
+    }
+
+    static CScript NodeScript(int n)
+    {
+        uint160 id;
+        WriteLE32(id.begin(), n);
+        return GetScriptForDestination(CKeyID(id));
+    }
+
+    static CInfinitynode Node(int n, int nSinType, int nHeight)
+    {
+        CInfinitynode inf(PROTOCOL_VERSION, COutPoint(ArithToUint256(arith_uint256(n + 1)), 0));
+        inf.setHeight(nHeight);
+        inf.setSINType(nSinType);
+        inf.setScriptPublicKey(NodeScript(n));
+        return inf;
+    }
+
+    static const CBlockIndex* ListTip(CInfinitynodeMan& man)
+    {
+        LOCK(man.cs);
+        return man.pindexListTip;
+    }
+
+    /** Heights of the blocks the manager keeps undo data for */
+    static std::vector<int> UndoHeights(CInfinitynodeMan& man)
+    {
+        LOCK(man.cs);
+        std::vector<int> vHeight;
+        for (const auto& undopair : man.mapBlockUndo)
+            vHeight.push_back(undopair.second.nHeight);
+        std::sort(vHeight.begin(), vHeight.end());
+        return vHeight;
+    }
+
+    /** What a list looks like from outside: the nodes and the last paid heights */
+    struct State
+    {
+        std::map<COutPoint, int> mapMatured; //! with their last reward height
+        std::set<COutPoint> setNonMatured;
+        std::map<CScript, int> mapLastPaid;
+
+        bool operator==(const State& other) const
+        {
+            return mapMatured == other.mapMatured && setNonMatured == other.setNonMatured && mapLastPaid == other.mapLastPaid;
+        }
+    };
+
+    static State GetState(CInfinitynodeMan& man)
+    {
+        LOCK2(man.cs, man.cs_LastPaid);
+        State state;
+        for (auto& infpair : man.mapInfinitynodes)
+            state.mapMatured[infpair.first] = infpair.second.getLastRewardHeight();
+        for (auto& infpair : man.mapInfinitynodesNonMatured)
+            state.setNonMatured.insert(infpair.first);
+        state.mapLastPaid.insert(man.mapLastPaid.begin(), man.mapLastPaid.end());
+        return state;
+    }
+
+    /** Connect the chain ending at pindex from its first block to a new manager */
+    State FullState(const CBlockIndex* pindex)
+    {
+        std::vector<const CBlockIndex*> vChain;
+        for (; pindex; pindex = pindex->pprev)
+            vChain.push_back(pindex);
+        CInfinitynodeMan man;
+        for (auto it = vChain.rbegin(); it != vChain.rend(); ++it)
+            Connect(man, *it);
+        return GetState(man);
+    }
+
+    static std::map<int, int> Statements(CInfinitynodeMan& man, int nSinType)
+    {
+        LOCK(man.cs);
+        return nSinType == 10 ? man.mapStatementBIG : nSinType == 5 ? man.mapStatementMID : man.mapStatementLIL;
+    }
+
+    /** The statements of nSinType recomputed from the genesis statement over all matured nodes */
+    static std::map<int, int> FullStatements(CInfinitynodeMan& man, int nSinType)
+    {
+        LOCK(man.cs);
+        std::map<int, int> mapStatement;
+        int stm_height_temp = Params().GetConsensus().nInfinityNodeGenesisStatement;
+        while (stm_height_temp < man.nCachedBlockHeight)
+        {
+            int totalSinType = 0;
+            int nNextHeight = -1;
+            for (auto& infpair : man.mapInfinitynodes) {
+                CInfinitynode& inf = infpair.second;
+                if (inf.getSINType() != nSinType) continue;
+                if (inf.getHeight() < stm_height_temp && stm_height_temp <= inf.getExpireHeight()) ++totalSinType;
+                if (inf.getHeight() >= stm_height_temp && (nNextHeight < 0 || inf.getHeight() < nNextHeight)) nNextHeight = inf.getHeight();
+            }
+            mapStatement[stm_height_temp] = totalSinType;
+            if (totalSinType == 0) {
+                if (nNextHeight < 0) break;
+                stm_height_temp = nNextHeight + 1;
+                continue;
+            }
+            stm_height_temp = stm_height_temp + totalSinType;
+        }
+        return mapStatement;
+    }
+
+    /** Rank of the nodes of nSinType paid by a statement starting at nBlockHeight, by scanning all nodes */
+    static std::map<int, CInfinitynode> FullRank(CInfinitynodeMan& man, int nBlockHeight, int nSinType)
+    {
+        LOCK(man.cs);
+        std::vector<std::pair<int, CInfinitynode*> > vecCInfinitynodeHeight;
+        for (auto& infpair : man.mapInfinitynodes) {
+            CInfinitynode& inf = infpair.second;
+            if (inf.getSINType() == nSinType && inf.getExpireHeight() >= nBlockHeight && inf.getHeight() < nBlockHeight)
+                vecCInfinitynodeHeight.push_back(std::make_pair(inf.getHeight(), &inf));
+        }
+        std::sort(vecCInfinitynodeHeight.begin(), vecCInfinitynodeHeight.end(),
+                  [](const std::pair<int, CInfinitynode*>& t1, const std::pair<int, CInfinitynode*>& t2) {
+            return (t1.first != t2.first) ? (t1.first < t2.first) : (t1.second->vinBurnFund < t2.second->vinBurnFund);
+        });
+        std::map<int, CInfinitynode> mapRank;
+        int rank = 1;
+        for (const auto& s : vecCInfinitynodeHeight)
+            mapRank[rank++] = *s.second;
+        return mapRank;
+    }
+
+    /** The node paid at nBlockHeight, by scanning all statements and nodes */
+    static bool FullRewardAtHeight(CInfinitynodeMan& man, int nBlockHeight, int nSinType, CInfinitynode& infinitynodeRet)
+    {
+        int nDelta = 100000;
+        int lastStatement = 0;
+        for (const auto& stm : Statements(man, nSinType)) {
+            if (nBlockHeight > stm.first && nDelta > (nBlockHeight - stm.first)) {
+                nDelta = nBlockHeight - stm.first;
+                if (nDelta <= stm.second) lastStatement = stm.first;
+            }
+        }
+        if (lastStatement == 0) return false;
+        infinitynodeRet = FullRank(man, lastStatement, nSinType)[nBlockHeight - lastStatement];
+        return true;
+    }
+
+    /** Compare the node paid at each height of the statements with a full scan */
+    static void CheckRewards(CInfinitynodeMan& man)
+    {
+        const int nGenesisHeight = Params().GetConsensus().nInfinityNodeGenesisStatement;
+        for (int nSinType : {10, 5, 1}) {
+            std::map<int, int> mapStatement = Statements(man, nSinType);
+            int nEndHeight = mapStatement.empty() ? nGenesisHeight : mapStatement.rbegin()->first + mapStatement.rbegin()->second + 2;
+            for (int nHeight = nGenesisHeight; nHeight <= nEndHeight; ++nHeight) {
+                CInfinitynode inf, infFull;
+                bool fFound = man.deterministicRewardAtHeight(nHeight, nSinType, inf);
+                BOOST_CHECK_EQUAL(fFound, FullRewardAtHeight(man, nHeight, nSinType, infFull));
+                BOOST_CHECK(inf.vinBurnFund == infFull.vinBurnFund);
+            }
+        }
+    }
+
+    /** Rank the nodes of nSinType for a statement starting at nBlockHeight and compare with a full scan */
+    static void CheckRanks(CInfinitynodeMan& man, int nBlockHeight, int nSinType)
+    {
+        std::map<COutPoint, int> mapExpected;
+        for (auto& rankpair : FullRank(man, nBlockHeight, nSinType))
+            mapExpected[rankpair.second.vinBurnFund.prevout] = rankpair.first;
+
+        LOCK(man.cs);
+        std::map<COutPoint, int> mapOtherRank;
+        for (auto& infpair : man.mapInfinitynodes) {
+            if (infpair.second.getSINType() != nSinType)
+                mapOtherRank[infpair.first] = infpair.second.getRank();
+        }
+        man.calculInfinityNodeRank(nBlockHeight, nSinType);
+        for (auto& infpair : man.mapInfinitynodes) {
+            CInfinitynode& inf = infpair.second;
+            if (inf.getSINType() == nSinType) {
+                BOOST_CHECK_EQUAL(inf.getRank(), mapExpected.count(infpair.first) ? mapExpected[infpair.first] : 0);
+            } else {
+                // the other types are left alone
+                BOOST_CHECK_EQUAL(inf.getRank(), mapOtherRank[infpair.first]);
+            }
+        }
+    }
+
+    /**
+     * Compare the last paid heights with the newest payments of the chain
+     * ending at pindex, and the heights of the matured nodes with the full
+     * pass of updateLastPaid()
+     */
+    void CheckLastPaid(CInfinitynodeMan& man, const CBlockIndex* pindex)
+    {
+        std::map<CScript, int> mapExpected;
+        for (; pindex; pindex = pindex->pprev) {
+            for (const CScript& payee : mapScan.at(pindex).vPayees)
+                mapExpected.emplace(payee, pindex->nHeight);
+        }
+        State state = GetState(man);
+        BOOST_CHECK(state.mapLastPaid == mapExpected);
+
+        LOCK2(man.cs, man.cs_LastPaid);
+        man.updateLastPaid();
+        for (auto& infpair : man.mapInfinitynodes)
+            BOOST_CHECK_EQUAL(state.mapMatured.at(infpair.first), infpair.second.getLastRewardHeight());
+    }
+
+    /** Extend the statements as CheckAndRemove() does and compare them up to the tip with a full recompute */
+    static void CheckStatements(CInfinitynodeMan& man)
+    {
+        if (!man.Count()) return;
+        for (int nSinType : {10, 5, 1}) {
+            man.deterministicRewardStatement(nSinType);
+            // statements after a reorged tip are kept, they are extended from again
+            std::map<int, int> mapStatement = Statements(man, nSinType);
+            mapStatement.erase(mapStatement.lower_bound(man.nCachedBlockHeight), mapStatement.end());
+            BOOST_CHECK(mapStatement == FullStatements(man, nSinType));
+        }
+    }
+};
+
+struct RegTestingSetup : public BasicTestingSetup {
+    RegTestingSetup() : BasicTestingSetup(CBaseChainParams::REGTEST) {}
+};
+
+BOOST_FIXTURE_TEST_SUITE(infinitynodeman_tests, RegTestingSetup)
+
+/** A node burnt every 7 blocks of a branch, paid back from height 150 on */
+static CInfinitynodeBlockScan ScanAt(int nHeight, int nBranch)
+{
+    CInfinitynodeBlockScan scan;
+    if (nHeight % 7 == 3) {
+        int nSinType = nHeight % 3 == 0 ? 10 : nHeight % 3 == 1 ? 5 : 1;
+        scan.vNodes.push_back(CInfinitynodeManTest::Node(nBranch * 1000 + nHeight, nSinType, nHeight));
+    }
+    if (nHeight >= 150 && nHeight % 5 == 0) {
+        int nPaidHeight = 3 + 7 * ((nHeight * 13 + nBranch) % (nHeight / 7 - 10));
+        scan.vPayees.push_back(CInfinitynodeManTest::NodeScript(nPaidHeight));
+        // a payee paid twice by a block
+        if (nHeight % 35 == 0)
+            scan.vPayees.push_back(CInfinitynodeManTest::NodeScript(nPaidHeight));
+    }
+    return scan;
+}
+
+BOOST_AUTO_TEST_CASE(blocks_connect_and_disconnect)
+{
+    CInfinitynodeManTest chain;
+    CInfinitynodeMan man;
+    const int INF_MATURED_LIMIT = CInfinitynodeManTest::INF_MATURED_LIMIT;
+
+    std::vector<CInfinitynodeManTest::State> vState;
+    const CBlockIndex* pindex = nullptr;
+    for (int nHeight = 0; nHeight < 300; ++nHeight) {
+        pindex = chain.AddBlock(pindex, ScanAt(nHeight, 0));
+        chain.Connect(man, pindex);
+        vState.push_back(CInfinitynodeManTest::GetState(man));
+    }
+    BOOST_CHECK(!vState.back().mapMatured.empty());
+    BOOST_CHECK(!vState.back().setNonMatured.empty());
+    BOOST_CHECK(!vState.back().mapLastPaid.empty());
+
+    // undo data is kept for the last INF_MATURED_LIMIT blocks only
+    std::vector<int> vUndoHeight = CInfinitynodeManTest::UndoHeights(man);
+    BOOST_CHECK_EQUAL(vUndoHeight.size(), (size_t)INF_MATURED_LIMIT);
+    BOOST_CHECK_EQUAL(vUndoHeight.front(), pindex->nHeight - INF_MATURED_LIMIT + 1);
+    BOOST_CHECK_EQUAL(vUndoHeight.back(), pindex->nHeight);
+
+    // each disconnected block puts the list back as it was before the block
+    for (int nHeight = 299; nHeight > 250; --nHeight) {
+        chain.Disconnect(man, pindex);
+        pindex = pindex->pprev;
+        BOOST_CHECK(CInfinitynodeManTest::GetState(man) == vState[nHeight - 1]);
+    }
+
+    // a longer branch gives the same list as connecting it from scratch
+    for (int nHeight = 251; nHeight < 330; ++nHeight) {
+        pindex = chain.AddBlock(pindex, ScanAt(nHeight, 1));
+        chain.Connect(man, pindex);
+    }
+    BOOST_CHECK(CInfinitynodeManTest::GetState(man) == chain.FullState(pindex));
+    BOOST_CHECK_EQUAL(CInfinitynodeManTest::UndoHeights(man).size(), (size_t)INF_MATURED_LIMIT);
+    BOOST_CHECK_EQUAL(man.GetSnapshot()->mapInfinitynodes.size(), CInfinitynodeManTest::GetState(man).mapMatured.size());
+
+    // deeper than the undo data, the list is cleared and waits for a rescan
+    for (int i = 0; i < INF_MATURED_LIMIT; ++i) {
+        chain.Disconnect(man, pindex);
+        pindex = pindex->pprev;
+    }
+    BOOST_CHECK(man.Count() > 0);
+    BOOST_CHECK(CInfinitynodeManTest::UndoHeights(man).empty());
+    chain.Disconnect(man, pindex);
+    BOOST_CHECK_EQUAL(man.Count(), 0);
+    BOOST_CHECK(CInfinitynodeManTest::GetState(man) == CInfinitynodeManTest::State());
+    BOOST_CHECK(CInfinitynodeManTest::ListTip(man) == nullptr);
+    BOOST_CHECK(man.GetSnapshot()->mapInfinitynodes.empty());
+
+    // and blocks are no longer connected to it
+    pindex = chain.AddBlock(pindex->pprev, ScanAt(pindex->nHeight, 2));
+    chain.BlockConnected(man, pindex);
+    BOOST_CHECK(CInfinitynodeManTest::GetState(man) == CInfinitynodeManTest::State());
+}
+
+BOOST_AUTO_TEST_CASE(reward_at_height_matches_full_scan)
+{
+    CInfinitynodeManTest chain;
+    CInfinitynodeMan man;
+
+    // the statement index is dropped and rebuilt as nodes mature and statements grow
+    const CBlockIndex* pindex = nullptr;
+    for (int nHeight = 0; nHeight < 400; ++nHeight) {
+        pindex = chain.AddBlock(pindex, ScanAt(nHeight, 0));
+        chain.Connect(man, pindex);
+        if (nHeight % 25 == 0) {
+            CInfinitynodeManTest::CheckStatements(man);
+            CInfinitynodeManTest::CheckRewards(man);
+        }
+    }
+    BOOST_CHECK(CInfinitynodeManTest::Statements(man, 10).size() > 2);
+
+    // and when a reorg removes nodes
+    for (int i = 0; i < 30; ++i) {
+        chain.Disconnect(man, pindex);
+        pindex = pindex->pprev;
+    }
+    CInfinitynodeManTest::CheckStatements(man);
+    CInfinitynodeManTest::CheckRewards(man);
+    for (int nHeight = pindex->nHeight + 1; nHeight < 420; ++nHeight) {
+        pindex = chain.AddBlock(pindex, ScanAt(nHeight, 1));
+        chain.Connect(man, pindex);
+    }
+    CInfinitynodeManTest::CheckStatements(man);
+    CInfinitynodeManTest::CheckRewards(man);
+}
+
+BOOST_AUTO_TEST_CASE(rank_matches_full_scan)
+{
+    CInfinitynodeManTest chain;
+    CInfinitynodeMan man;
+
+    const CBlockIndex* pindex = nullptr;
+    for (int nHeight = 0; nHeight < 400; ++nHeight) {
+        pindex = chain.AddBlock(pindex, ScanAt(nHeight, 0));
+        chain.Connect(man, pindex);
+        if (nHeight % 50 == 0) {
+            for (int nSinType : {10, 5, 1})
+                CInfinitynodeManTest::CheckRanks(man, nHeight, nSinType);
+        }
+    }
+
+    // at each statement, and between them where nodes start being paid
+    CInfinitynodeManTest::CheckStatements(man);
+    for (int nSinType : {10, 5, 1}) {
+        for (const auto& stm : CInfinitynodeManTest::Statements(man, nSinType)) {
+            CInfinitynodeManTest::CheckRanks(man, stm.first, nSinType);
+            CInfinitynodeManTest::CheckRanks(man, stm.first + 1, nSinType);
+        }
+    }
+
+    // after a reorg removed nodes from the type arrays
+    for (int i = 0; i < 30; ++i) {
+        chain.Disconnect(man, pindex);
+        pindex = pindex->pprev;
+    }
+    for (int nSinType : {10, 5, 1}) {
+        for (int nHeight = 100; nHeight < pindex->nHeight; nHeight += 9)
+            CInfinitynodeManTest::CheckRanks(man, nHeight, nSinType);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(last_paid_matches_full_update)
+{
+    CInfinitynodeManTest chain;
+    CInfinitynodeMan man;
+
+    const CBlockIndex* pindex = nullptr;
+    for (int nHeight = 0; nHeight < 300; ++nHeight) {
+        pindex = chain.AddBlock(pindex, ScanAt(nHeight, 0));
+        chain.Connect(man, pindex);
+        if (nHeight % 10 == 0)
+            chain.CheckLastPaid(man, pindex);
+    }
+    BOOST_CHECK(!CInfinitynodeManTest::GetState(man).mapLastPaid.empty());
+
+    // payments undone by a reorg, then made again by another branch
+    for (int i = 0; i < 40; ++i) {
+        chain.Disconnect(man, pindex);
+        pindex = pindex->pprev;
+        chain.CheckLastPaid(man, pindex);
+    }
+    for (int nHeight = pindex->nHeight + 1; nHeight < 320; ++nHeight) {
+        pindex = chain.AddBlock(pindex, ScanAt(nHeight, 1));
+        chain.Connect(man, pindex);
+        chain.CheckLastPaid(man, pindex);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(statements_extend_over_reorg)
+{
+    CInfinitynodeManTest chain;
+    CInfinitynodeMan man;
+
+    // no BIG node before the genesis statement, no LIL node at all
+    std::map<int, std::pair<int, int>> mapBurn = {
+        {105, {0, 5}}, {120, {1, 10}}, {121, {2, 10}}, {150, {3, 10}}, {200, {4, 10}},
+        {260, {5, 10}}, {300, {6, 5}}, {330, {7, 10}}, {335, {8, 10}}, {370, {9, 10}},
+    };
+    const CBlockIndex* pindex = nullptr;
+    for (int nHeight = 0; nHeight < 400; ++nHeight) {
+        CInfinitynodeBlockScan scan;
+        if (mapBurn.count(nHeight))
+            scan.vNodes.push_back(CInfinitynodeManTest::Node(mapBurn[nHeight].first, mapBurn[nHeight].second, nHeight));
+        pindex = chain.AddBlock(pindex, scan);
+        chain.Connect(man, pindex);
+        CInfinitynodeManTest::CheckStatements(man);
+    }
+
+    // the BIG statements go on once the first BIG node can be paid
+    std::map<int, int> mapBIG = CInfinitynodeManTest::Statements(man, 10);
+    BOOST_CHECK_EQUAL(mapBIG.at(110), 0);
+    BOOST_CHECK_EQUAL(mapBIG.at(121), 1);
+    BOOST_CHECK(mapBIG.rbegin()->first + mapBIG.rbegin()->second >= 399);
+    BOOST_CHECK(CInfinitynodeManTest::Statements(man, 1) == (std::map<int, int>{{110, 0}}));
+
+    // replace the last 40 blocks with a longer branch burning other nodes
+    const CBlockIndex* pindexFork = pindex->GetAncestor(359);
+    for (; pindex != pindexFork; pindex = pindex->pprev) {
+        chain.Disconnect(man, pindex);
+        CInfinitynodeManTest::CheckStatements(man);
+    }
+    for (int nHeight = 360; nHeight < 450; ++nHeight) {
+        CInfinitynodeBlockScan scan;
+        if (nHeight == 365 || nHeight == 366)
+            scan.vNodes.push_back(CInfinitynodeManTest::Node(nHeight, 10, nHeight));
+        pindex = chain.AddBlock(pindex, scan);
+        chain.Connect(man, pindex);
+        CInfinitynodeManTest::CheckStatements(man);
+    }
+    CInfinitynode inf;
+    BOOST_CHECK(man.Get(CInfinitynodeManTest::Node(365, 10, 365).vinBurnFund.prevout, inf));
+    BOOST_CHECK(!man.Get(CInfinitynodeManTest::Node(9, 10, 370).vinBurnFund.prevout, inf));
+}
+
+BOOST_AUTO_TEST_CASE(snapshot_published_per_block)
+{
+    CInfinitynodeManTest chain;
+    CInfinitynodeMan man;
+
+    const CBlockIndex* pindex = nullptr;
+    for (int nHeight = 0; nHeight < 200; ++nHeight) {
+        pindex = chain.AddBlock(pindex);
+        chain.Connect(man, pindex);
+    }
+
+    // adding nodes and extending statements leave the published list alone
+    std::shared_ptr<const CInfinitynodeSnapshot> snap = man.GetSnapshot();
+    for (int n = 0; n < 10; ++n) {
+        CInfinitynode inf = CInfinitynodeManTest::Node(n, 10, 100 + n);
+        BOOST_CHECK(man.Add(inf));
+    }
+    BOOST_CHECK(man.deterministicRewardStatement(10));
+    BOOST_CHECK(man.GetSnapshot() == snap);
+    BOOST_CHECK(snap->mapInfinitynodes.empty());
+
+    // the next block publishes all of them at once
+    pindex = chain.AddBlock(pindex);
+    chain.Connect(man, pindex);
+    BOOST_CHECK(man.GetSnapshot() != snap);
+    BOOST_CHECK_EQUAL(man.GetSnapshot()->mapInfinitynodes.size(), 10U);
+
+    snap = man.GetSnapshot();
+    chain.Disconnect(man, pindex);
+    BOOST_CHECK(man.GetSnapshot() != snap);
+    BOOST_CHECK_EQUAL(man.GetSnapshot()->mapInfinitynodes.size(), 10U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
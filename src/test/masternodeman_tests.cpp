@@ -0,0 +1,355 @@
+// Copyright (c) 2018-2019 SIN developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <masternodeman.h>
+
+#include <arith_uint256.h>
+#include <chainparams.h>
+#include <key.h>
+#include <masternode-payments.h>
+#include <masternode-sync.h>
+#include <netbase.h>
+#include <script/interpreter.h>
+#include <script/standard.h>
+#include <streams.h>
+#include <test/test_sin.h>
+#include <utilstrencodings.h>
+#include <utiltime.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+/** The masternode list as the indexes of CMasternodeMan replaced: scanned in full */
+struct CMasternodeManTest
+{
+    std::vector<CKey> vKey;
+
+    explicit CMasternodeManTest(int nKeys)
+    {
+        for (int i = 0; i < nKeys; ++i) {
+            vKey.emplace_back();
+            vKey.back().MakeNewKey(true);
+        }
+    }
+
+    CScript Payee(int nKey) const
+    {
+        return GetScriptForDestination(vKey[nKey].GetPubKey().GetID());
+    }
+
+    /** Masternode n with the collateral of key nKey, burning nBurnFund */
+    CMasternode Masternode(int n, int nKey, int nBurnFund, int nSinType, int64_t sigTime) const
+    {
+        CService addr = LookupNumeric(strprintf("10.0.%d.%d", n / 256, n % 256).c_str(), 20970);
+        CMasternode mn(addr, COutPoint(ArithToUint256(arith_uint256(n + 1)), 0), COutPoint(ArithToUint256(arith_uint256(nBurnFund + 1)), 1),
+                       vKey[nKey].GetPubKey(), vKey[nKey].GetPubKey(), PROTOCOL_VERSION);
+        mn.nSinType = nSinType;
+        mn.sigTime = sigTime;
+        mn.fUnitTest = true;
+        return mn;
+    }
+
+    /** The first masternode of the list paying to payee */
+    static bool FullPayeeLookup(CMasternodeMan& man, const CScript& payee, COutPoint& outpointRet)
+    {
+        for (const auto& mnpair : man.GetFullMasternodeMap()) {
+            if (GetScriptForDestination(mnpair.second.pubKeyCollateralAddress.GetID()) == payee) {
+                outpointRet = mnpair.first;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static std::set<COutPoint> Outpoints(CMasternodeMan& man)
+    {
+        std::set<COutPoint> setOutpoint;
+        for (const auto& mnpair : man.GetFullMasternodeMap())
+            setOutpoint.insert(mnpair.first);
+        return setOutpoint;
+    }
+
+    /** The masternodes left by the full scan CheckAndRemoveBurnFundNotUniqueNode() made */
+    static std::set<COutPoint> FullBurnFundCheck(const std::vector<CMasternode>& vMasternode)
+    {
+        std::map<COutPoint, CMasternode> mapMasternodes;
+        for (const CMasternode& mn : vMasternode)
+            mapMasternodes.emplace(mn.vin.prevout, mn);
+        std::map<COutPoint, CMasternode> nBurnFundMap;
+        for (const auto& mnpair : mapMasternodes) {
+            const CMasternode& mnb = mnpair.second;
+            auto it = nBurnFundMap.find(mnb.vinBurnFund.prevout);
+            // conflict situation with someone else, choose older sigtime
+            if (it == nBurnFundMap.end() || it->second.sigTime > mnb.sigTime)
+                nBurnFundMap[mnb.vinBurnFund.prevout] = mnb;
+        }
+        std::set<COutPoint> setOutpoint;
+        for (const auto& burnpair : nBurnFundMap)
+            setOutpoint.insert(burnpair.second.vin.prevout);
+        return setOutpoint;
+    }
+
+    /** The masternodes left by the full scan CheckAndRemoveLimitNumberNode() made */
+    static std::set<COutPoint> FullLimitCheck(CMasternodeMan& man, int nSinType, int nLimit)
+    {
+        std::map<COutPoint, CMasternode> mapMasternodes = man.GetFullMasternodeMap();
+        std::vector<std::pair<int64_t, CMasternode*> > vecSigTimeType;
+        for (auto& mnpair : mapMasternodes) {
+            if (mnpair.second.GetSinTypeInt() == nSinType)
+                vecSigTimeType.push_back(std::make_pair(mnpair.second.sigTime, &mnpair.second));
+        }
+        std::sort(vecSigTimeType.begin(), vecSigTimeType.end(),
+                  [](const std::pair<int64_t, CMasternode*>& t1, const std::pair<int64_t, CMasternode*>& t2) {
+            return (t1.first != t2.first) ? (t1.first < t2.first) : (t1.second->vin < t2.second->vin);
+        });
+        std::set<COutPoint> setOutpoint = Outpoints(man);
+        if ((int)vecSigTimeType.size() <= nLimit) return setOutpoint;
+        int count = 0;
+        for (const auto& p : vecSigTimeType) {
+            if (++count >= nLimit)
+                setOutpoint.erase(p.second->vin.prevout);
+        }
+        return setOutpoint;
+    }
+
+    static int FullCountSinType(CMasternodeMan& man, int nSinType)
+    {
+        int nCount = 0;
+        for (auto& mnpair : man.GetFullMasternodeMap()) {
+            if (mnpair.second.GetSinTypeInt() == nSinType) ++nCount;
+        }
+        return nCount;
+    }
+
+    /** Heights of the blocks the last paid index keeps for any payee */
+    static std::vector<int> PaidHeights(CMasternodeMan& man)
+    {
+        LOCK(man.cs);
+        std::vector<int> vHeight;
+        for (const auto& payeepair : man.mapPayeePaidBlocks) {
+            for (const CBlockIndex* pindex : payeepair.second)
+                vHeight.push_back(pindex->nHeight);
+        }
+        std::sort(vHeight.begin(), vHeight.end());
+        return vHeight;
+    }
+
+    /** Compare the payee lookups of every key with a full scan */
+    void CheckPayees(CMasternodeMan& man) const
+    {
+        for (size_t i = 0; i < vKey.size(); ++i) {
+            COutPoint outpoint;
+            bool fFound = FullPayeeLookup(man, Payee(i), outpoint);
+            BOOST_CHECK_EQUAL(man.IsPayeeAValidMasternode(Payee(i)), fFound ? 2 : 0);
+            masternode_info_t info;
+            BOOST_CHECK_EQUAL(man.GetMasternodeInfo(Payee(i), info), fFound);
+            if (fFound)
+                BOOST_CHECK(info.vin.prevout == outpoint);
+        }
+    }
+};
+
+/** Testing setup with the masternode list synced, so its checks run */
+struct MasternodeTestingSetup : public TestingSetup {
+    MasternodeTestingSetup()
+    {
+        masternodeSync.Reset();
+        while (!masternodeSync.IsMasternodeListSynced())
+            masternodeSync.SwitchToNextAsset(*connman);
+    }
+    ~MasternodeTestingSetup()
+    {
+        masternodeSync.Reset();
+    }
+};
+
+BOOST_FIXTURE_TEST_SUITE(masternodeman_tests, MasternodeTestingSetup)
+
+BOOST_AUTO_TEST_CASE(payee_index_matches_full_scan)
+{
+    // the last key pays no masternode
+    CMasternodeManTest test(6);
+    CMasternodeMan man;
+
+    test.CheckPayees(man);
+    for (int n = 0; n < 20; ++n) {
+        CMasternode mn = test.Masternode(19 - n, n % 5, n, 10, 1000 + n);
+        BOOST_CHECK(man.Add(mn));
+        test.CheckPayees(man);
+    }
+    CMasternode mnDuplicate = test.Masternode(3, 5, 100, 10, 900);
+    BOOST_CHECK(!man.Add(mnDuplicate));
+    test.CheckPayees(man);
+
+    // the index is rebuilt when mncache.dat is loaded
+    CDataStream ss(SER_DISK, CLIENT_VERSION);
+    ss << man;
+    CMasternodeMan manLoaded;
+    ss >> manLoaded;
+    BOOST_CHECK_EQUAL(manLoaded.size(), 20);
+    test.CheckPayees(manLoaded);
+
+    man.Clear();
+    test.CheckPayees(man);
+
+    // without the list, any payee is allowed
+    masternodeSync.Reset();
+    BOOST_CHECK_EQUAL(manLoaded.IsPayeeAValidMasternode(test.Payee(5)), 1);
+}
+
+BOOST_AUTO_TEST_CASE(burn_fund_and_sin_type_checks_match_full_scan)
+{
+    CMasternodeManTest test(4);
+    CMasternodeMan man;
+
+    // three burn funds shared, one of them by two masternodes with the same sigTime
+    std::vector<CMasternode> vMasternode = {
+        test.Masternode(0, 0, 0, 10, 1000), test.Masternode(1, 1, 0, 10, 900), test.Masternode(2, 2, 0, 10, 950),
+        test.Masternode(3, 3, 1, 10, 500), test.Masternode(4, 0, 1, 10, 500),
+        test.Masternode(5, 1, 2, 5, 700), test.Masternode(6, 2, 2, 5, 600),
+    };
+    for (int n = 7; n < 20; ++n)
+        vMasternode.push_back(test.Masternode(n, n % 4, n, n % 2 ? 5 : 10, 2000 - 10 * n));
+    // a burn fund already held is given to the masternode with the oldest
+    // sigTime when the next one is added, whatever order they come in
+    std::set<COutPoint> setExpected = CMasternodeManTest::FullBurnFundCheck(vMasternode);
+    for (int nOrder = 0; nOrder < 3; ++nOrder) {
+        man.Clear();
+        if (nOrder == 1)
+            std::reverse(vMasternode.begin(), vMasternode.end());
+        if (nOrder == 2)
+            std::rotate(vMasternode.begin(), vMasternode.begin() + 3, vMasternode.end());
+        for (CMasternode& mn : vMasternode)
+            BOOST_CHECK_EQUAL(man.Add(mn), man.Has(mn.vin.prevout));
+        BOOST_CHECK(CMasternodeManTest::Outpoints(man) == setExpected);
+        BOOST_CHECK_EQUAL(man.size(), (int)vMasternode.size() - 4);
+        test.CheckPayees(man);
+    }
+    for (int nSinType : {1, 5, 10})
+        BOOST_CHECK_EQUAL(man.CountSinType(nSinType), CMasternodeManTest::FullCountSinType(man, nSinType));
+
+    // nothing is removed by the periodic checks until the list is synced
+    masternodeSync.Reset();
+    man.CheckAndRemoveLimitNumberNode(*connman, 10, 3);
+    man.CheckAndRemoveBurnFundNotUniqueNode(*connman);
+    BOOST_CHECK(CMasternodeManTest::Outpoints(man) == setExpected);
+    while (!masternodeSync.IsMasternodeListSynced())
+        masternodeSync.SwitchToNextAsset(*connman);
+    man.CheckAndRemoveBurnFundNotUniqueNode(*connman);
+    BOOST_CHECK(CMasternodeManTest::Outpoints(man) == setExpected);
+
+    // the SIN type index follows the types Check() finds for the masternodes
+    for (int n : {7, 9, 10}) {
+        man.Find(COutPoint(ArithToUint256(arith_uint256(n + 1)), 0))->nSinType = 1;
+    }
+    man.Check();
+    for (int nSinType : {1, 5, 10})
+        BOOST_CHECK_EQUAL(man.CountSinType(nSinType), CMasternodeManTest::FullCountSinType(man, nSinType));
+
+    for (int nSinType : {1, 5, 10}) {
+        for (int nLimit : {8, 5, 3}) {
+            setExpected = CMasternodeManTest::FullLimitCheck(man, nSinType, nLimit);
+            man.CheckAndRemoveLimitNumberNode(*connman, nSinType, nLimit);
+            BOOST_CHECK(CMasternodeManTest::Outpoints(man) == setExpected);
+            BOOST_CHECK_EQUAL(man.CountSinType(nSinType), CMasternodeManTest::FullCountSinType(man, nSinType));
+        }
+    }
+    // nLimit - 1 masternodes are kept once there are more than nLimit
+    BOOST_CHECK_EQUAL(man.CountSinType(10), 2);
+    test.CheckPayees(man);
+}
+
+BOOST_AUTO_TEST_CASE(last_paid_index_pruned_without_update)
+{
+    CMasternodeManTest test(7);
+    CMasternodeMan man;
+    const int nStorageLimit = mnpayments.GetStorageLimit();
+    const int nFirstHeight = 200000;
+    const int nBlocks = nStorageLimit + 1000;
+
+    // UpdateLastPaid() only runs on masternodes, so connecting blocks alone
+    // must keep the index to the blocks payment votes are stored for
+    std::deque<uint256> vHash;
+    std::deque<CBlockIndex> vIndex;
+    for (int i = 0; i < nBlocks; ++i) {
+        const int nHeight = nFirstHeight + i;
+        CMutableTransaction coinbase;
+        coinbase.vin.resize(1);
+        coinbase.vout.emplace_back(GetMasternodePayment(nHeight, 1), test.Payee(i % 7));
+        CBlock block;
+        block.vtx.push_back(MakeTransactionRef(std::move(coinbase)));
+        block.nNonce = i;
+
+        vHash.push_back(block.GetHash());
+        vIndex.emplace_back();
+        CBlockIndex& index = vIndex.back();
+        index.phashBlock = &vHash.back();
+        index.nHeight = nHeight;
+        index.pprev = i > 0 ? &vIndex[i - 1] : nullptr;
+        man.UpdateLastPaidIndex(block, &index);
+    }
+
+    const int nTipHeight = nFirstHeight + nBlocks - 1;
+    std::vector<int> vHeight = CMasternodeManTest::PaidHeights(man);
+    BOOST_CHECK_EQUAL(vHeight.size(), (size_t)nStorageLimit);
+    BOOST_CHECK_EQUAL(vHeight.front(), nTipHeight - nStorageLimit + 1);
+    BOOST_CHECK_EQUAL(vHeight.back(), nTipHeight);
+}
+
+BOOST_FIXTURE_TEST_CASE(broadcast_with_held_burn_fund_rejected, TestChain100Setup)
+{
+    CMasternodeManTest test(2);
+    CMasternodeMan man;
+
+    // a collateral for each key in one block
+    CScript scriptCoinbase = CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG;
+    CMutableTransaction tx;
+    tx.vin.resize(1);
+    tx.vin[0].prevout = COutPoint(m_coinbase_txns[0]->GetHash(), 0);
+    tx.vout.emplace_back(Params().GetConsensus().nMasternodeCollateralMinimum * COIN, test.Payee(0));
+    tx.vout.emplace_back(Params().GetConsensus().nMasternodeCollateralMinimum * COIN, test.Payee(1));
+    tx.vout.emplace_back(m_coinbase_txns[0]->vout[0].nValue - 2 * tx.vout[0].nValue - CENT, scriptCoinbase);
+    std::vector<unsigned char> vchSig;
+    uint256 hash = SignatureHash(scriptCoinbase, tx, 0, SIGHASH_ALL, 0, SigVersion::BASE);
+    BOOST_CHECK(coinbaseKey.Sign(hash, vchSig));
+    vchSig.push_back((unsigned char)SIGHASH_ALL);
+    tx.vin[0].scriptSig << vchSig;
+    CreateAndProcessBlock({tx}, scriptCoinbase);
+    BOOST_CHECK(pcoinsTip->HaveCoin(COutPoint(tx.GetHash(), 1)));
+
+    // two broadcasts burning the same fund, the second one signed later
+    const COutPoint burnfund(ArithToUint256(arith_uint256(1000)), 1);
+    std::vector<CMasternodeBroadcast> vBroadcast;
+    for (int n = 0; n < 2; ++n) {
+        CService addr = LookupNumeric(strprintf("10.0.0.%d", n + 1).c_str(), Params().GetDefaultPort());
+        CMasternodeBroadcast mnb(addr, COutPoint(tx.GetHash(), n), burnfund,
+                                 test.vKey[n].GetPubKey(), test.vKey[n].GetPubKey(), PROTOCOL_VERSION);
+        SetMockTime(chainActive.Tip()->GetBlockTime() + 100 * (n + 1));
+        BOOST_CHECK(mnb.Sign(test.vKey[n]));
+        vBroadcast.push_back(mnb);
+    }
+
+    int nDos = -1;
+    BOOST_CHECK(man.CheckMnbAndUpdateMasternodeList(nullptr, vBroadcast[0], nDos, *connman));
+    BOOST_CHECK_EQUAL(nDos, 0);
+    BOOST_CHECK(man.Has(vBroadcast[0].vin.prevout));
+
+    // the newer one is not added, and the peer is not punished for it
+    nDos = -1;
+    BOOST_CHECK(!man.CheckMnbAndUpdateMasternodeList(nullptr, vBroadcast[1], nDos, *connman));
+    BOOST_CHECK_EQUAL(nDos, 0);
+    BOOST_CHECK(!man.Has(vBroadcast[1].vin.prevout));
+    BOOST_CHECK_EQUAL(man.size(), 1);
+
+    // the other way round, the older one takes the burn fund over
+    man.Clear();
+    BOOST_CHECK(man.CheckMnbAndUpdateMasternodeList(nullptr, vBroadcast[1], nDos, *connman));
+    BOOST_CHECK(man.CheckMnbAndUpdateMasternodeList(nullptr, vBroadcast[0], nDos, *connman));
+    BOOST_CHECK(man.Has(vBroadcast[0].vin.prevout));
+    BOOST_CHECK(!man.Has(vBroadcast[1].vin.prevout));
+
+    SetMockTime(0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
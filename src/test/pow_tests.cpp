@@ -5,6 +5,7 @@
 #include <chain.h>
 #include <chainparams.h>
 #include <pow.h>
+#include <primitives/block.h>
 #include <random.h>
 #include <util.h>
 #include <test/test_sin.h>
@@ -55,4 +56,29 @@ BOOST_AUTO_TEST_CASE(GetBlockProofEquivalentTime_test)
     }
 }
 
+/* Test that hashing from the header midstate matches hashing the whole header */
+BOOST_AUTO_TEST_CASE(header_midstate_pow_hash)
+{
+    CBlockHeader header;
+    header.nVersion = InsecureRand32();
+    header.hashPrevBlock = InsecureRand256();
+    header.hashMerkleRoot = InsecureRand256();
+    header.nTime = InsecureRand32();
+    header.nBits = 0x1e0ffff0;
+
+    // Both sides of the X22I to X25X switch
+    for (int nHeight : {nSinHeightMainnet - 1, nSinHeightMainnet}) {
+        const uint32_t nFirstNonce = InsecureRand32();
+        const CBlockHeaderMidstate midstate(header, nHeight);
+        std::vector<uint256> hashes(19);
+        midstate.GetPoWHashes(nFirstNonce, hashes.size(), hashes.data());
+        for (size_t i = 0; i < hashes.size(); ++i) {
+            header.nNonce = nFirstNonce + i;
+            uint256 hash = header.GetPoWHash(nHeight);
+            BOOST_CHECK_EQUAL(hashes[i], hash);
+            BOOST_CHECK_EQUAL(midstate.GetPoWHash(header.nNonce), hash);
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
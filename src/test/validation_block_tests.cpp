@@ -181,4 +181,39 @@ BOOST_AUTO_TEST_CASE(processnewblock_signals_ordering)
     BOOST_CHECK_EQUAL(sub.m_expected_tip, chainActive.Tip()->GetBlockHash());
 }
 
+BOOST_FIXTURE_TEST_CASE(read_trusted_block, TestChain100Setup)
+{
+    // A copy of the tip entry whose hashes are not those of the block: a
+    // read that ran the hash chains would not hand them back.
+    CBlockIndex index;
+    {
+        LOCK(cs_main);
+        index = *chainActive.Tip();
+    }
+    const uint256 hashBlock = InsecureRand256();
+    index.phashBlock = &hashBlock;
+    index.hashPoW = InsecureRand256();
+
+    CBlock block;
+    BOOST_CHECK(ReadBlockFromDisk(block, &index, Params().GetConsensus()));
+    BOOST_CHECK_EQUAL(block.GetHash(), hashBlock);
+    BOOST_CHECK_EQUAL(block.GetPoWHash(index.nHeight), index.hashPoW);
+    BOOST_CHECK_EQUAL(block.GetCachedPoWHash(index.nHeight), index.hashPoW);
+
+    // Without a stored proof of work hash only the block hash is kept
+    index.hashPoW.SetNull();
+    BOOST_CHECK(ReadBlockFromDisk(block, &index, Params().GetConsensus()));
+    BOOST_CHECK_EQUAL(block.GetHash(), hashBlock);
+    BOOST_CHECK(block.GetCachedPoWHash(index.nHeight).IsNull());
+
+    // Changing the header drops the hashes taken from the index
+    block.nNonce++;
+    BOOST_CHECK(block.GetHash() != hashBlock);
+
+    // -checkblockreads hashes the block and finds it doesn't match the entry
+    fCheckBlockReads = true;
+    BOOST_CHECK(!ReadBlockFromDisk(block, &index, Params().GetConsensus()));
+    fCheckBlockReads = DEFAULT_CHECK_BLOCK_READS;
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -22,6 +22,7 @@ static const char DB_COIN = 'C';
 static const char DB_COINS = 'c';
 static const char DB_BLOCK_FILES = 'f';
 static const char DB_BLOCK_INDEX = 'b';
+static const char DB_BLOCK_POWHASH = 'P';
 
 static const char DB_BEST_BLOCK = 'B';
 static const char DB_HEAD_BLOCKS = 'H';
@@ -230,6 +231,9 @@ bool CBlockTreeDB::WriteBatchSync(const std::vector<std::pair<int, const CBlockF
     batch.Write(DB_LAST_BLOCK, nLastFile);
     for (std::vector<const CBlockIndex*>::const_iterator it=blockinfo.begin(); it != blockinfo.end(); it++) {
         batch.Write(std::make_pair(DB_BLOCK_INDEX, (*it)->GetBlockHash()), CDiskBlockIndex(*it));
+        // Kept under its own key so that the block index record format stays unchanged
+        if (!(*it)->hashPoW.IsNull())
+            batch.Write(std::make_pair(DB_BLOCK_POWHASH, (*it)->GetBlockHash()), (*it)->hashPoW);
     }
     return WriteBatch(batch, true);
 }
@@ -292,6 +296,24 @@ bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams,
         }
     }
 
+    // Load the proof of work hashes recorded when the headers were accepted.
+    // Checking them against nBits is cheap, unlike recomputing X25X above.
+    pcursor->Seek(std::make_pair(DB_BLOCK_POWHASH, uint256()));
+    while (pcursor->Valid()) {
+        boost::this_thread::interruption_point();
+        std::pair<char, uint256> key;
+        if (pcursor->GetKey(key) && key.first == DB_BLOCK_POWHASH) {
+            CBlockIndex* pindex = insertBlockIndex(key.second);
+            if (!pcursor->GetValue(pindex->hashPoW))
+                return error("%s: failed to read proof of work hash", __func__);
+            if (!CheckProofOfWork(pindex->hashPoW, pindex->nBits, consensusParams))
+                return error("%s: CheckProofOfWork failed: %s", __func__, pindex->ToString());
+            pcursor->Next();
+        } else {
+            break;
+        }
+    }
+
     return true;
 }
 
@@ -236,6 +236,7 @@ CWaitableCriticalSection g_best_block_mutex;
 CConditionVariable g_best_block_cv;
 uint256 g_best_block;
 int nScriptCheckThreads = 0;
+int nHeaderCheckThreads = 0;
 std::atomic_bool fImporting(false);
 std::atomic_bool fReindex(false);
 bool fHavePruned = false;
@@ -243,6 +244,7 @@ bool fPruneMode = false;
 bool fIsBareMultisigStd = DEFAULT_PERMIT_BAREMULTISIG;
 bool fRequireStandard = true;
 bool fCheckBlockIndex = false;
+bool fCheckBlockReads = DEFAULT_CHECK_BLOCK_READS;
 bool fCheckpointsEnabled = DEFAULT_CHECKPOINTS_ENABLED;
 size_t nCoinCacheUsage = 5000 * 300;
 uint64_t nPruneTarget = 0;
@@ -1144,7 +1146,7 @@ static bool WriteBlockToDisk(const CBlock& block, CDiskBlockPos& pos, const CMes
     return true;
 }
 
-bool ReadBlockFromDisk(CBlock& block, const CDiskBlockPos& pos, int nHeight, const Consensus::Params& consensusParams)
+static bool ReadBlockDataFromDisk(CBlock& block, const CDiskBlockPos& pos)
 {
     block.SetNull();
 
@@ -1161,7 +1163,16 @@ bool ReadBlockFromDisk(CBlock& block, const CDiskBlockPos& pos, int nHeight, con
         return error("%s: Deserialize or I/O error - %s at %s", __func__, e.what(), pos.ToString());
     }
 
-    // Check the header
+    return true;
+}
+
+bool ReadBlockFromDisk(CBlock& block, const CDiskBlockPos& pos, int nHeight, const Consensus::Params& consensusParams)
+{
+    if (!ReadBlockDataFromDisk(block, pos))
+        return false;
+
+    // Check the header, keeping its hashes for the caller
+    block.CacheHashes(nHeight);
     if (!CheckProofOfWork(block.GetPoWHash(nHeight), block.nBits, consensusParams))
         return error("ReadBlockFromDisk: Errors in block header at %s", pos.ToString());
 
@@ -1171,13 +1182,41 @@ bool ReadBlockFromDisk(CBlock& block, const CDiskBlockPos& pos, int nHeight, con
 bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams)
 {
     CDiskBlockPos blockPos;
+    uint256 hashPoW;
+    bool fTrusted;
     {
         LOCK(cs_main);
         blockPos = pindex->GetBlockPos();
+        hashPoW = pindex->hashPoW;
+        // Blocks are only written after CheckBlock() succeeded, so once the index
+        // says so their proof of work and hash have been verified already.
+        fTrusted = !fCheckBlockReads && pindex->IsValid(BLOCK_VALID_TRANSACTIONS);
     }
 
     int nHeight = pindex->nHeight;
 
+    if (fTrusted) {
+        // Skip the X25X/X22I chains: compare the header field by field against
+        // the index entry (which hashes to GetBlockHash()) and check the stored
+        // transactions against the merkle root, which is plain SHA256 over txids
+        // that deserialization computed anyway.
+        if (!ReadBlockDataFromDisk(block, blockPos))
+            return false;
+        const CBlockHeader header = pindex->GetBlockHeader();
+        if (block.nVersion != header.nVersion || block.hashPrevBlock != header.hashPrevBlock ||
+            block.hashMerkleRoot != header.hashMerkleRoot || block.nTime != header.nTime ||
+            block.nBits != header.nBits || block.nNonce != header.nNonce)
+            return error("ReadBlockFromDisk(CBlock&, CBlockIndex*): header doesn't match index for %s at %s",
+                    pindex->ToString(), blockPos.ToString());
+        if (BlockMerkleRoot(block) != block.hashMerkleRoot)
+            return error("ReadBlockFromDisk(CBlock&, CBlockIndex*): merkle root mismatch for %s at %s",
+                    pindex->ToString(), blockPos.ToString());
+        // Hand the verified hashes on, so GetHash() and CheckBlock() don't
+        // run the chains either
+        block.SetCachedHashes(pindex->GetBlockHash(), hashPoW, nHeight);
+        return true;
+    }
+
     if (!ReadBlockFromDisk(block, blockPos, nHeight, consensusParams))
         return false;
     if (block.GetHash() != pindex->GetBlockHash())
@@ -1632,7 +1671,9 @@ bool UndoWriteToDisk(const CBlockUndo& blockundo, CDiskBlockPos& pos, const uint
     return true;
 }
 
-static bool UndoReadFromDisk(CBlockUndo& blockundo, const CBlockIndex *pindex)
+} // namespace
+
+bool UndoReadFromDisk(CBlockUndo& blockundo, const CBlockIndex *pindex)
 {
     CDiskBlockPos pos = pindex->GetUndoPos();
     if (pos.IsNull()) {
@@ -1663,6 +1704,8 @@ static bool UndoReadFromDisk(CBlockUndo& blockundo, const CBlockIndex *pindex)
     return true;
 }
 
+namespace {
+
 /** Abort with a message */
 static bool AbortNode(const std::string& strMessage, const std::string& userMessage="")
 {
@@ -1832,6 +1875,74 @@ void ThreadScriptCheck() {
     scriptcheckqueue.Thread();
 }
 
+/** Closure representing the hashing and proof of work check of one block header */
+class CHeaderCheck
+{
+private:
+    CBlockHeader *pheaders;
+    size_t nCount;
+    int nFirstHeight;
+    const Consensus::Params *pconsensus;
+
+public:
+    CHeaderCheck(): pheaders(nullptr), nCount(0), nFirstHeight(0), pconsensus(nullptr) {}
+    CHeaderCheck(CBlockHeader* headers, size_t nCountIn, int nFirstHeightIn, const Consensus::Params& consensusParams) :
+        pheaders(headers), nCount(nCountIn), nFirstHeight(nFirstHeightIn), pconsensus(&consensusParams) {}
+
+    bool operator()() {
+        // Both hashes stay memoized on the headers for AcceptBlockHeader()
+        CBlockHeader::PrecomputeHashes(pheaders, nCount, nFirstHeight);
+        for (size_t i = 0; i < nCount; ++i) {
+            int nHeight = nFirstHeight + (int)i;
+            if (Params().NetworkIDString() == CBaseChainParams::MAIN && nHeight < SKIP_BLOCKHEADER_POW)
+                continue;
+            if (!CheckProofOfWork(pheaders[i].GetPoWHash(nHeight), pheaders[i].nBits, *pconsensus))
+                return false;
+        }
+        return true;
+    }
+
+    void swap(CHeaderCheck& check) {
+        std::swap(pheaders, check.pheaders);
+        std::swap(nCount, check.nCount);
+        std::swap(nFirstHeight, check.nFirstHeight);
+        std::swap(pconsensus, check.pconsensus);
+    }
+};
+
+/** Number of headers hashed together by one header check job */
+static const size_t HEADERCHECK_BATCH_SIZE = 8;
+
+static CCheckQueue<CHeaderCheck> headercheckqueue(16);
+
+void ThreadHeaderCheck() {
+    RenameThread("sin-headerch");
+    headercheckqueue.Thread();
+}
+
+bool CheckBlockHeadersPoW(std::vector<CBlockHeader>& headers, int nFirstHeight, const Consensus::Params& consensusParams)
+{
+    AssertLockNotHeld(cs_main);
+
+    if (!nHeaderCheckThreads)
+        return true;
+
+    // Workers take checks from the back of the queue, so add the batches in
+    // reverse order: a bad header early in the list then stops the
+    // remaining work quickly instead of after hashing everything.
+    std::vector<CHeaderCheck> vChecks;
+    vChecks.reserve(headers.size() / HEADERCHECK_BATCH_SIZE + 1);
+    for (size_t end = headers.size(); end > 0; ) {
+        size_t begin = end > HEADERCHECK_BATCH_SIZE ? end - HEADERCHECK_BATCH_SIZE : 0;
+        vChecks.emplace_back(&headers[begin], end - begin, nFirstHeight + (int)begin, consensusParams);
+        end = begin;
+    }
+
+    CCheckQueueControl<CHeaderCheck> control(&headercheckqueue);
+    control.Add(vChecks);
+    return control.Wait();
+}
+
 // Protected by cs_main
 VersionBitsCache versionbitscache;
 
@@ -3166,6 +3277,8 @@ CBlockIndex* CChainState::AddToBlockIndex(const CBlockHeader& block)
         pindexNew->nHeight = pindexNew->pprev->nHeight + 1;
         pindexNew->BuildSkip();
     }
+    // Keep the proof of work hash memoized on the header, so it is never redone
+    pindexNew->hashPoW = block.GetCachedPoWHash(pindexNew->nHeight);
     pindexNew->nTimeMax = (pindexNew->pprev ? std::max(pindexNew->pprev->nTimeMax, pindexNew->nTime) : pindexNew->nTime);
     pindexNew->nChainWork = (pindexNew->pprev ? pindexNew->pprev->nChainWork : 0) + GetBlockProof(*pindexNew);
     pindexNew->RaiseValidity(BLOCK_VALID_TREE);